@@ -5,6 +5,9 @@
 #include <string.h>
 #include <limits.h>
 #include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
 
 // An enumerator (enum for short) to represent the state
 enum STATE {
@@ -19,6 +22,8 @@ static const char *STATES[] = { "NEW", "READY", "RUNNING", "WAITING", "TERMINATE
 // A structure containing all the relevant meta data for a process, this is the PCB like struct
 // The io_time_remaining is used in two ways: 
 // it counts how long until the next io call and how long until a current io call is complete
+// A process with a burst list takes its CPU and I/O burst lengths from burst_count entries of the
+// burst arena starting at burst_offset, burst_index is the next one to use
 struct process
 {
 	int pid;
@@ -28,10 +33,16 @@ struct process
     int io_frequency;
     int io_duration;
     int io_time_remaining;
+    int burst_offset, burst_count, burst_index;
     int priority;
 	int memory_required;
     enum STATE s;
     int wait_time, turnaround_time;
+    int predicted_burst, current_burst;
+    int partition_key;
+    int slot;
+    int deadline, period, current_job, released_jobs;
+    int last_run;
 };
 
 
@@ -45,6 +56,55 @@ struct node {
 typedef struct process *proc_t;
 typedef struct node *node_t;
 
+// The burst lists of all processes, stored back to back as CPU, I/O, CPU, I/O, ..., CPU burst lengths
+// Processes refer to their list by offset so the arena can grow without invalidating them
+struct burst_arena
+{
+    int *bursts;
+    int count;
+    int capacity;
+};
+static struct burst_arena burst_arena = { NULL, 0, 0 };
+
+/* FUNCTION DESCRIPTION: add_burst
+* Appends a burst length to the burst arena, doubling its size when it is full.
+* The return value is the offset of the new burst
+*/
+int add_burst(int burst){
+    if(burst_arena.count == burst_arena.capacity){
+        burst_arena.capacity = burst_arena.capacity ? burst_arena.capacity*2 : 1024;
+        burst_arena.bursts = (int *) realloc(burst_arena.bursts, burst_arena.capacity*sizeof(int));
+    }
+    burst_arena.bursts[burst_arena.count] = burst;
+    return burst_arena.count++;
+}
+
+/* FUNCTION DESCRIPTION: next_cpu_burst
+* Returns how long the process runs before its next io call.
+* Without a burst list this is the io_frequency, with one it is the next CPU burst,
+* or -1 (never blocks again, as with an io_frequency of -1) once the last CPU burst has started
+*/
+int next_cpu_burst(proc_t p){
+    int burst;
+
+    if(p->burst_count == 0) return p->io_frequency;
+    if(p->burst_index >= p->burst_count) return -1;
+
+    burst = burst_arena.bursts[p->burst_offset + p->burst_index++];
+    // The last burst of the list is a CPU burst with no io call after it
+    if(p->burst_index >= p->burst_count) return -1;
+    return burst;
+}
+
+/* FUNCTION DESCRIPTION: next_io_burst
+* Returns how long the io call the process is blocking on takes.
+* Without a burst list this is the io_duration, with one it is the next I/O burst
+*/
+int next_io_burst(proc_t p){
+    if(p->burst_count == 0 || p->burst_index >= p->burst_count) return p->io_duration;
+    return burst_arena.bursts[p->burst_offset + p->burst_index++];
+}
+
 /* FUNCTION DESCRIPTION: create_proc
 * This function creates a new process structure.
 * The parameters are self descriptive: 
@@ -76,9 +136,21 @@ proc_t create_proc(int pid, int arrival_time, int total_cpu_time, int io_frequen
     temp->io_time_remaining = io_frequency;
     temp->priority = priority;
 	temp->memory_required = memory_required;
+    temp->burst_offset = 0;
+    temp->burst_count = 0;
+    temp->burst_index = 0;
     temp->s = STATE_NEW;
     temp->wait_time=0;
     temp->turnaround_time=0;
+    temp->predicted_burst=0;
+    temp->current_burst=0;
+    temp->partition_key=0;
+    temp->slot=0;
+    temp->deadline=0;
+    temp->period=0;
+    temp->current_job=0;
+    temp->released_jobs=0;
+    temp->last_run=-1;
     return temp;
 }
 
@@ -163,18 +235,115 @@ int remove_node(node_t *head, node_t to_be_removed){
     return -1;
 }
 
+/* FUNCTION DESCRIPTION: find_column
+* Finds a column by name in the CSV header row, ignoring surrounding spaces.
+* The return value is the index of the column or -1 if the header does not have it
+*/
+int find_column(char *header, char *name){
+    char *c = header;
+    int column = 0, length = strlen(name);
+
+    while(*c != '\0'){
+        while(*c == ' ') c++;
+        if(strncmp(c, name, length) == 0){
+            char *end = c + length;
+            while(*end == ' ' || *end == '\r' || *end == '\n') end++;
+            if(*end == ',' || *end == '\0') return column;
+        }
+        while(*c != '\0' && *c != ',') c++;
+        if(*c == ',') c++;
+        column++;
+    }
+    return -1;
+}
+
+/* FUNCTION DESCRIPTION: optional_field
+* Returns true if column is one of the optional columns after the first 7 and the row has a value in it
+*/
+static bool optional_field(char **fields, int field_count, int column){
+    char *c;
+    if(column < 7 || column >= field_count) return false;
+    for(c = fields[column]; *c == ' ' || *c == '\t'; c++);
+    return *c != '\0';
+}
+
+/* FUNCTION DESCRIPTION: partition_key
+* Turns a Tenant or Floor field into the key of its workload partition. A number is its own key,
+* any other name ("acme", "tenant-b") is hashed with FNV-1a, ignoring surrounding spaces.
+*/
+static int partition_key(char *field){
+    char *end;
+    unsigned int hash = 2166136261u;
+    long key;
+
+    while(*field == ' ' || *field == '\t') field++;
+    key = strtol(field, &end, 10);
+    if(end != field && strspn(end, " \t") == strlen(end)) return (int) key;
+
+    end = field + strlen(field);
+    while(end > field && (end[-1] == ' ' || end[-1] == '\t')) end--;
+    for(; field < end; field++) hash = (hash ^ (unsigned char) *field) * 16777619u;
+    return (int) hash;
+}
+
+/* FUNCTION DESCRIPTION: read_bursts
+* Parses a burst list column, lengths separated by spaces (or any other non digit but a comma),
+* into the burst arena and attaches it to the process.
+* If the Total CPU Time column is 0 the process total becomes the sum of its CPU bursts, otherwise
+* it must equal that sum. A burst that is not a positive length stops the program with an error
+* naming the row, since the simulation would never finish it.
+*/
+void read_bursts(proc_t p, char *field, int row_number){
+    char *end;
+    long burst;
+    int cpu_total = 0;
+
+    p->burst_offset = burst_arena.count;
+    while(*field != '\0'){
+        burst = strtol(field, &end, 10);
+        if(end == field){
+            field++;
+            continue;
+        }
+        if(burst <= 0 || burst > INT_MAX){
+            printf("Error! Row %d: burst %ld must be a positive length\n", row_number, burst);
+            exit(1);
+        }
+        if(p->burst_count % 2 == 0) cpu_total += burst;
+        add_burst((int) burst);
+        p->burst_count++;
+        field = end;
+    }
+
+    if(p->burst_count > 0 && p->total_cpu_time == 0){
+        p->total_cpu_time = cpu_total;
+        p->cpu_time_remaining = cpu_total;
+    }
+    else if(p->burst_count > 0 && p->total_cpu_time != cpu_total){
+        printf("Error! Row %d: the CPU bursts add up to %d but the Total CPU Time is %d\n", row_number, cpu_total, p->total_cpu_time);
+        exit(1);
+    }
+    p->io_time_remaining = next_cpu_burst(p);
+}
+
 /* FUNCTION DESCRIPTION: read_proc_from_file
 * Parse the CSV input file and load its contents into a list
+* The first 7 columns are fixed, optional columns after them are found by their name in the header:
+*    -Bursts: the CPU and I/O burst lengths of the process, CPU first, see read_bursts
+*    -Tenant (or Floor): the workload partition the process belongs to, see partitioned
+*    -Deadline and Period: the relative deadline and release period of a real time task, see realtime
 * The parameters are: 
 * The return value is a list of thes new prcesses
 */
 node_t read_proc_from_file(char *input_file) {
 
-	int MAXCHAR = 2000;
+	int MAXCHAR = 2000, MAXFIELDS = 16;
     char row[MAXCHAR];
-    node_t new_list=NULL, node;
+    char *fields[MAXFIELDS];
+    node_t new_list=NULL, tail=NULL, node;
     proc_t proc;
     int pid, arrival_time, total_cpu_time, io_frequency, io_duration, priority, memory_required;
+    int field_count, bursts_column, partition_column, deadline_column, period_column, row_number = 1;
 
     FILE* f = fopen(input_file, "r");
     if(f == NULL){
@@ -185,30 +354,54 @@ node_t read_proc_from_file(char *input_file) {
     // Get the first row, which has the header values
     //Pid;Arrival Time;Total CPU Time;I/O Frequency;I/O Duration
     fgets(row, MAXCHAR, f);
+    bursts_column = find_column(row, "Bursts");
+    partition_column = find_column(row, "Tenant");
+    if(partition_column < 0) partition_column = find_column(row, "Floor");
+    deadline_column = find_column(row, "Deadline");
+    period_column = find_column(row, "Period");
+
     // Read the remainder of the rows until you get to the end of the file
-    do {
-        // get the next data row
-        fgets(row, MAXCHAR, f);
-        // atoi turns a string into an integer
-        // strtok(row,";") tokenizes the row around the ';' charaters
-        // strtok(NULL, ";") gets the next token in the row
+    while(fgets(row, MAXCHAR, f) != NULL) {
+        row_number++;
+        // Split the row at every ',' ourselves, unlike strtok this keeps empty fields so a blank optional
+        // column does not shift the columns after it
         // We are assuming that the file is setup as a CSV in the correct format
-        pid = atoi(strtok(row, ","));
-        arrival_time = atoi(strtok(NULL, ","));
-        total_cpu_time = atoi(strtok(NULL, ","));
-        io_frequency = atoi(strtok(NULL, ","));
-        io_duration = atoi(strtok(NULL, ","));
-        priority = atoi(strtok(NULL, ","));
-        memory_required = atoi(strtok(NULL, ","));
+        row[strcspn(row, "\r\n")] = '\0';
+        field_count = 0;
+        for(char *field = row; field != NULL && field_count < MAXFIELDS; ) {
+            fields[field_count++] = field;
+            field = strchr(field, ',');
+            if(field != NULL) *field++ = '\0';
+        }
+        // Skip blank lines
+        if(field_count < 7) continue;
+
+        // atoi turns a string into an integer
+        pid = atoi(fields[0]);
+        arrival_time = atoi(fields[1]);
+        total_cpu_time = atoi(fields[2]);
+        io_frequency = atoi(fields[3]);
+        io_duration = atoi(fields[4]);
+        priority = atoi(fields[5]);
+        memory_required = atoi(fields[6]);
 
         printf("%d, %d, %d, %d, %d, %d, %d\n", pid, arrival_time, total_cpu_time, io_frequency, io_duration, priority, memory_required);
 
         // We create a process struct and pass it too create node, then add this node to the new_list
         proc = create_proc(pid, arrival_time, total_cpu_time, io_frequency, io_duration, priority, memory_required);
+        // An empty optional field keeps the default create_proc gave the process
+        if(optional_field(fields, field_count, bursts_column)) read_bursts(proc, fields[bursts_column], row_number);
+        if(optional_field(fields, field_count, partition_column)) proc->partition_key = partition_key(fields[partition_column]);
+        if(optional_field(fields, field_count, deadline_column)) proc->deadline = atoi(fields[deadline_column]);
+        if(optional_field(fields, field_count, period_column)) proc->period = atoi(fields[period_column]);
         node = create_node(proc);
-        new_list = push_node(new_list, node);
-        
-    } while(!feof(f));
+
+        // Append through the tail so reading stays linear in the number of processes
+        if(tail == NULL) new_list = node;
+        else tail->next = node;
+        tail = node;
+    }
+    fclose(f);
 
     return new_list;
 }
@@ -228,6 +421,51 @@ void clean_up(node_t list){
     }
 }
 
+// An open addressing hash index from int keys to their positions 0, 1, 2, ... in order of insertion,
+// so callers keep their entries in a plain array. Slots hold a position or -1 when empty.
+struct key_index
+{
+    int *keys;
+    int *slots;
+    int count, capacity;
+};
+
+/* FUNCTION DESCRIPTION: find_or_insert_key
+* Finds the position of key, adding it at position count if it has not been seen yet.
+* The slots are kept at most half full and double in size, so linear probing stays short.
+* inserted tells the caller whether to initialise a new entry at the returned position
+*/
+int find_or_insert_key(struct key_index *index, int key, bool *inserted){
+    unsigned int h;
+    int i;
+
+    if(index->count*2 >= index->capacity){
+        free(index->slots);
+        index->capacity = index->capacity ? index->capacity*2 : 64;
+        index->slots = (int *) malloc(index->capacity*sizeof(int));
+        index->keys = (int *) realloc(index->keys, index->capacity/2*sizeof(int));
+        memset(index->slots, -1, index->capacity*sizeof(int));
+        for(i=0; i<index->count; i++){
+            h = ((unsigned int) index->keys[i] * 2654435761u) & (index->capacity-1);
+            while(index->slots[h] >= 0) h = (h+1) & (index->capacity-1);
+            index->slots[h] = i;
+        }
+    }
+
+    h = ((unsigned int) key * 2654435761u) & (index->capacity-1);
+    while(index->slots[h] >= 0){
+        if(index->keys[index->slots[h]] == key){
+            *inserted = false;
+            return index->slots[h];
+        }
+        h = (h+1) & (index->capacity-1);
+    }
+    index->keys[index->count] = key;
+    index->slots[h] = index->count;
+    *inserted = true;
+    return index->count++;
+}
+
 /* FUNCTION DESCRIPTION: get_highest_priority
 * Returns the process with the highest priority in head
 */
@@ -264,6 +502,10 @@ node_t get_first_fit(node_t head, int size) {
     return NULL;
 }
 
+// The simulation loops stop at this time even if processes are left, the verification harness lowers it
+// so that workloads which never finish (as happens after some priority() preemptions) can still be compared
+static int clock_limit = INT_MAX;
+
 // A structure containing all the relevant meta data for a memory partition, this is the memory like struct
 typedef struct Partition
 {
@@ -273,26 +515,19 @@ typedef struct Partition
 } Partition;
 
 
-/* FUNCTION DESCRIPTION: fcfs
-* First Come First Serve algorith implimentation
+/* FUNCTION DESCRIPTION: fcfs_run
+* Runs the First Come First Serve simulation loop over the processes in new_list, writing the transitions to file
+* The return value is the list of terminated processes
 */
-void fcfs(char *input_file, char *output_file) 
+node_t fcfs_run(node_t new_list, FILE *file)
 {
-	int cpu_clock, avg_wt=0, avg_tt=0, proc_count=0;
+	int cpu_clock;
 	bool simulation_completed = false;
-	node_t ready_list = NULL, new_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
+	node_t ready_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
     node_t running = NULL;
 
-    // Process meta data should be read from a text file
-    printf("FCFS Scheduler for %s\n", input_file);
-    new_list = read_proc_from_file(input_file);
-
-	//open output file and write heading to file
-	FILE *file = fopen(output_file, "w");
-    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
-
     // Simulation loop
-    for(cpu_clock=0; simulation_completed==false; cpu_clock++) 
+    for(cpu_clock=0; simulation_completed==false && cpu_clock<clock_limit; cpu_clock++) 
     {
     	// Advance all the io timers for processes in waiting state
         node = waiting_list;
@@ -304,7 +539,7 @@ void fcfs(char *input_file, char *output_file)
                 // Update the time of next io event to the frequency of its occurance
                 // add it to the ready queue and remove it from waiting list
                 node->p->s = STATE_READY;
-                node->p->io_time_remaining = node->p->io_frequency;
+                node->p->io_time_remaining = next_cpu_burst(node->p);
 
                 temp = node->next;
                 remove_node(&waiting_list, node);
@@ -374,7 +609,7 @@ void fcfs(char *input_file, char *output_file)
             } 
             else if(running->p->io_time_remaining == 0){
                 // The process is blocked by io, update the timer and set state to waiting
-                running->p->io_time_remaining = running->p->io_duration;
+                running->p->io_time_remaining = next_io_burst(running->p);
                 running->p->s = STATE_WAITING;
                 waiting_list = push_node(waiting_list,running);
                 fprintf(file,"%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_WAITING]);
@@ -394,6 +629,27 @@ void fcfs(char *input_file, char *output_file)
         simulation_completed = (ready_list == NULL) && (new_list == NULL) && (waiting_list == NULL) && (running == NULL);
     }
 
+    return terminated;
+}
+
+/* FUNCTION DESCRIPTION: fcfs
+* First Come First Serve algorith implimentation
+*/
+void fcfs(char *input_file, char *output_file) 
+{
+	int avg_wt=0, avg_tt=0, proc_count=0;
+	node_t new_list = NULL, terminated = NULL, node;
+
+    // Process meta data should be read from a text file
+    printf("FCFS Scheduler for %s\n", input_file);
+    new_list = read_proc_from_file(input_file);
+
+	//open output file and write heading to file
+	FILE *file = fopen(output_file, "w");
+    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
+
+    terminated = fcfs_run(new_list, file);
+
     // Close the output file
     fclose(file);
 
@@ -411,26 +667,19 @@ void fcfs(char *input_file, char *output_file)
     clean_up(terminated);
 }
 
-/* FUNCTION DESCRIPTION: priority
-* Non-preemptive Priority algorith implimentation
+/* FUNCTION DESCRIPTION: priority_run
+* Runs the Non-preemptive Priority simulation loop over the processes in new_list, writing the transitions to file
+* The return value is the list of terminated processes
 */
-void priority(char *input_file, char *output_file) 
+node_t priority_run(node_t new_list, FILE *file)
 {
-	int cpu_clock, avg_wt=0, avg_tt=0, proc_count=0;
+	int cpu_clock;
 	bool simulation_completed = false;
-	node_t ready_list = NULL, new_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
+	node_t ready_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
     node_t running = NULL;
 
-    // Process meta data should be read from a text file
-    printf("Priority Scheduler for %s\n", input_file);
-    new_list = read_proc_from_file(input_file);
-
-	//open output file and write heading to file
-	FILE *file = fopen(output_file, "w");
-    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
-
     // Simulation loop
-    for(cpu_clock=0; simulation_completed==false; cpu_clock++) 
+    for(cpu_clock=0; simulation_completed==false && cpu_clock<clock_limit; cpu_clock++) 
     {
     	// Check if ready list has higher priority process against running process
     	if(running!=NULL && ready_list!=NULL) {
@@ -456,7 +705,7 @@ void priority(char *input_file, char *output_file)
                 // Update the time of next io event to the frequency of its occurance
                 // add it to the ready queue and remove it from waiting list
                 node->p->s = STATE_READY;
-                node->p->io_time_remaining = node->p->io_frequency;
+                node->p->io_time_remaining = next_cpu_burst(node->p);
 
                 temp = node->next;
                 remove_node(&waiting_list, node);
@@ -526,7 +775,7 @@ void priority(char *input_file, char *output_file)
             } 
             else if(running->p->io_time_remaining == 0){
                 // The process is blocked by io, update the timer and set state to waiting
-                running->p->io_time_remaining = running->p->io_duration;
+                running->p->io_time_remaining = next_io_burst(running->p);
                 running->p->s = STATE_WAITING;
                 waiting_list = push_node(waiting_list,running);
                 fprintf(file,"%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_WAITING]);
@@ -546,6 +795,27 @@ void priority(char *input_file, char *output_file)
         simulation_completed = (ready_list == NULL) && (new_list == NULL) && (waiting_list == NULL) && (running == NULL);
     }
 
+    return terminated;
+}
+
+/* FUNCTION DESCRIPTION: priority
+* Non-preemptive Priority algorith implimentation
+*/
+void priority(char *input_file, char *output_file) 
+{
+	int avg_wt=0, avg_tt=0, proc_count=0;
+	node_t new_list = NULL, terminated = NULL, node;
+
+    // Process meta data should be read from a text file
+    printf("Priority Scheduler for %s\n", input_file);
+    new_list = read_proc_from_file(input_file);
+
+	//open output file and write heading to file
+	FILE *file = fopen(output_file, "w");
+    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
+
+    terminated = priority_run(new_list, file);
+
     // Close the output file
     fclose(file);
 
@@ -563,26 +833,19 @@ void priority(char *input_file, char *output_file)
     clean_up(terminated);
 }
 
-/* FUNCTION DESCRIPTION: rr
-* Round Robin algorith implimentation
+/* FUNCTION DESCRIPTION: rr_run
+* Runs the Round Robin simulation loop over the processes in new_list, writing the transitions to file
+* The return value is the list of terminated processes
 */
-void rr(char *input_file, char *output_file, int time_quantum) 
+node_t rr_run(node_t new_list, FILE *file, int time_quantum)
 {
-	int cpu_clock, temp_quantum=time_quantum, avg_wt=0, avg_tt=0, proc_count=0;
+	int cpu_clock, temp_quantum=time_quantum;
 	bool simulation_completed = false;
-	node_t ready_list = NULL, new_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
+	node_t ready_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
     node_t running = NULL;
 
-    // Process meta data should be read from a text file
-    printf("RR Scheduler for %s\n", input_file);
-    new_list = read_proc_from_file(input_file);
-
-	//open output file and write heading to file
-	FILE *file = fopen(output_file, "w");
-    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
-
     // Simulation loop
-    for(cpu_clock=0; simulation_completed==false; cpu_clock++) 
+    for(cpu_clock=0; simulation_completed==false && cpu_clock<clock_limit; cpu_clock++) 
     {
     	if(running !=NULL && running->p->cpu_time_remaining!=0 && running->p->io_time_remaining == 0 && temp_quantum==0) {
     		// The process time quantum has expired, context switch from running to ready
@@ -602,7 +865,7 @@ void rr(char *input_file, char *output_file, int time_quantum)
                 // Update the time of next io event to the frequency of its occurance
                 // add it to the ready queue and remove it from waiting list
                 node->p->s = STATE_READY;
-                node->p->io_time_remaining = node->p->io_frequency;
+                node->p->io_time_remaining = next_cpu_burst(node->p);
 
                 temp = node->next;
                 remove_node(&waiting_list, node);
@@ -675,7 +938,7 @@ void rr(char *input_file, char *output_file, int time_quantum)
             } 
             else if(running->p->io_time_remaining == 0){
                 // The process is blocked by io, update the timer and set state to waiting
-                running->p->io_time_remaining = running->p->io_duration;
+                running->p->io_time_remaining = next_io_burst(running->p);
                 running->p->s = STATE_WAITING;
                 waiting_list = push_node(waiting_list,running);
                 fprintf(file,"%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_WAITING]);
@@ -696,6 +959,27 @@ void rr(char *input_file, char *output_file, int time_quantum)
         simulation_completed = (ready_list == NULL) && (new_list == NULL) && (waiting_list == NULL) && (running == NULL);
     }
 
+    return terminated;
+}
+
+/* FUNCTION DESCRIPTION: rr
+* Round Robin algorith implimentation
+*/
+void rr(char *input_file, char *output_file, int time_quantum) 
+{
+	int avg_wt=0, avg_tt=0, proc_count=0;
+	node_t new_list = NULL, terminated = NULL, node;
+
+    // Process meta data should be read from a text file
+    printf("RR Scheduler for %s\n", input_file);
+    new_list = read_proc_from_file(input_file);
+
+	//open output file and write heading to file
+	FILE *file = fopen(output_file, "w");
+    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
+
+    terminated = rr_run(new_list, file, time_quantum);
+
     // Close the output file
     fclose(file);
 
@@ -713,26 +997,19 @@ void rr(char *input_file, char *output_file, int time_quantum)
     clean_up(terminated);
 }
 
-/* FUNCTION DESCRIPTION: mm
-* Memory management First Fit implimentation
+/* FUNCTION DESCRIPTION: mm_run
+* Runs the Memory management simulation loop over the processes in new_list, writing the transitions to file
+* The return value is the list of terminated processes
 */
-void mm(char *input_file, char *output_file, Partition *memory_partition) 
+node_t mm_run(node_t new_list, FILE *file, Partition *memory_partition)
 {
-	int cpu_clock, total_memory_used=0, total_partition_memory_used=0, avg_wt=0, avg_tt=0, proc_count=0;
+	int cpu_clock, total_memory_used=0, total_partition_memory_used=0;
 	bool simulation_completed = false;
-	node_t ready_list = NULL, new_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
+	node_t ready_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
     node_t running = NULL;
 
-    // Process meta data should be read from a text file
-    printf("Memory Partition simulation for %s\n", input_file);
-    new_list = read_proc_from_file(input_file);
-
-	//open output file and write heading to file
-	FILE *file = fopen(output_file, "w");
-    fprintf(file,"%s, %s, %s, %s, %s, %s, %s, %s\n","Time of transition","PID","Old State","New State", "Total Memory Used", "Total Memory Free", "Total Usable Memory", "Partition Size");
-
     // Simulation loop
-    for(cpu_clock=0; simulation_completed==false; cpu_clock++) 
+    for(cpu_clock=0; simulation_completed==false && cpu_clock<clock_limit; cpu_clock++) 
     {
     	// Advance all the io timers for processes in waiting state
         node = waiting_list;
@@ -744,7 +1021,7 @@ void mm(char *input_file, char *output_file, Partition *memory_partition)
                 // Update the time of next io event to the frequency of its occurance
                 // add it to the ready queue and remove it from waiting list
                 node->p->s = STATE_READY;
-                node->p->io_time_remaining = node->p->io_frequency;
+                node->p->io_time_remaining = next_cpu_burst(node->p);
 
                 temp = node->next;
                 remove_node(&waiting_list, node);
@@ -820,7 +1097,7 @@ void mm(char *input_file, char *output_file, Partition *memory_partition)
                 } 
                 else if(running->p->io_time_remaining == 0){
                     // The process is blocked by io, update the timer and set state to waiting
-                    running->p->io_time_remaining = running->p->io_duration;
+                    running->p->io_time_remaining = next_io_burst(running->p);
                     running->p->s = STATE_WAITING;
                     total_partition_memory_used-=memory_partition[i].size;
                     total_memory_used-=running->p->memory_required;
@@ -840,6 +1117,27 @@ void mm(char *input_file, char *output_file, Partition *memory_partition)
         }
     }
 
+    return terminated;
+}
+
+/* FUNCTION DESCRIPTION: mm
+* Memory management First Fit implimentation
+*/
+void mm(char *input_file, char *output_file, Partition *memory_partition) 
+{
+	int avg_wt=0, avg_tt=0, proc_count=0;
+	node_t new_list = NULL, terminated = NULL, node;
+
+    // Process meta data should be read from a text file
+    printf("Memory Partition simulation for %s\n", input_file);
+    new_list = read_proc_from_file(input_file);
+
+	//open output file and write heading to file
+	FILE *file = fopen(output_file, "w");
+    fprintf(file,"%s, %s, %s, %s, %s, %s, %s, %s\n","Time of transition","PID","Old State","New State", "Total Memory Used", "Total Memory Free", "Total Usable Memory", "Partition Size");
+
+    terminated = mm_run(new_list, file, memory_partition);
+
     // Close the output file
     fclose(file);
 
@@ -857,78 +1155,3145 @@ void mm(char *input_file, char *output_file, Partition *memory_partition)
     clean_up(terminated);
 }
 
-int main(int argc, char *argv[])
+// Weight in percent given to the last observed CPU burst when updating a prediction,
+// the rest is given to the previous prediction (exponential averaging)
+#define PREDICTION_WEIGHT 50
+
+// An entry of a ready heap, seq breaks ties in arrival order so the simulation stays deterministic
+struct heap_entry
 {
-	if(argc>3) {
-		if(atoi(argv[3])==1) fcfs(argv[1],argv[2]);
-		if(atoi(argv[3])==2) priority(argv[1],argv[2]);
-		if(atoi(argv[3])==3) rr(argv[1],argv[2], atoi(argv[3]));
-		if(atoi(argv[3])==4) {
-			Partition memory_partition[4];
+    long long key;
+    int seq;
+    node_t node;
+};
 
-			for(int i=0, j=5; i<4; i++, j++) {
-				memory_partition[i].size=atoi(argv[j]);
-				memory_partition[i].occupied=false;
-			}
+// A binary min heap of ready processes ordered by key
+struct ready_heap
+{
+    struct heap_entry *entries;
+    int count;
+    int capacity;
+    int seq;
+};
 
-			if((memory_partition[0].size+memory_partition[1].size+memory_partition[2].size+memory_partition[3].size)>1000) {
-				printf("Error! total partition size greter than allocated 1Mb");
-				exit(1);
-			}
+/* FUNCTION DESCRIPTION: heap_less
+* Returns true if entry a should leave the heap before entry b
+*/
+static bool heap_less(struct heap_entry *a, struct heap_entry *b){
+    return a->key < b->key || (a->key == b->key && a->seq < b->seq);
+}
 
-			mm(argv[1],argv[2], memory_partition);
-		}
-	}
+/* FUNCTION DESCRIPTION: heap_push
+* Adds a node to the heap with the given key, O(log n)
+*/
+void heap_push(struct ready_heap *heap, node_t node, long long key){
+    struct heap_entry entry;
+    int i, parent;
 
-	else if(argc==3) {
-		int schedule, time_quantum;
-		Partition memory_partition[4];
+    if(heap->count == heap->capacity){
+        heap->capacity = heap->capacity ? heap->capacity*2 : 64;
+        heap->entries = (struct heap_entry *) realloc(heap->entries, heap->capacity*sizeof(struct heap_entry));
+    }
+    entry.key = key;
+    entry.seq = heap->seq++;
+    entry.node = node;
 
-		printf("1. First Come First Serve\n");
-		printf("2. Non-preemptive Priority\n");
-		printf("3. Round Robin\n");
-		printf("4. Memory management\n");
-		printf("Enter simulation option: ");
-		scanf("%d", &schedule);
-		
-		switch(schedule) {
-		case 1:
-			printf("\nRunning FCFS scheduler for %s\n",argv[1]);
-			printf("-------------------\n");
-			fcfs(argv[1],argv[2]);
-			break;
+    // Sift the new entry up from the bottom
+    for(i = heap->count++; i > 0; i = parent){
+        parent = (i-1)/2;
+        if(!heap_less(&entry, &heap->entries[parent])) break;
+        heap->entries[i] = heap->entries[parent];
+    }
+    heap->entries[i] = entry;
+}
 
-		case 2:
-			printf("\nRunning Non-preemptive Priority scheduler for %s\n",argv[1]);
-			printf("-------------------\n");
-			priority(argv[1],argv[2]);
-			break;
+/* FUNCTION DESCRIPTION: heap_pop
+* Removes the node with the smallest key from the heap, O(log n)
+* The return value is the node or NULL if the heap is empty
+*/
+node_t heap_pop(struct ready_heap *heap){
+    struct heap_entry last;
+    node_t top;
+    int i, child;
 
-		case 3:
-			printf("Enter Time quantum: ");
-			scanf("%d", &time_quantum);
-			printf("\nRunning Round Robin scheduler for %s\n",argv[1]);
-			printf("\nTime quantum: %d\n",time_quantum);
-			printf("-------------------\n");
-			rr(argv[1],argv[2], time_quantum);
-			break;
+    if(heap->count == 0) return NULL;
+    top = heap->entries[0].node;
+    last = heap->entries[--heap->count];
 
-		case 4:
-			printf("\nRunning Memory Management scheduler for %s\n",argv[1]);
-			printf("-------------------\n");
-			for(int i=0; i<4; i++) {
-				printf("Enter the size of partition %d: ",i+1);
-				scanf("%d", &memory_partition[i].size);
-				memory_partition[i].occupied=false;
-			}
+    // Sift the last entry down from the top
+    for(i = 0; (child = 2*i+1) < heap->count; i = child){
+        if(child+1 < heap->count && heap_less(&heap->entries[child+1], &heap->entries[child])) child++;
+        if(!heap_less(&heap->entries[child], &last)) break;
+        heap->entries[i] = heap->entries[child];
+    }
+    heap->entries[i] = last;
+    return top;
+}
 
-			if((memory_partition[0].size+memory_partition[1].size+memory_partition[2].size+memory_partition[3].size)>1000) {
-				printf("Error! total partition size greter than allocated 1Mb");
-				exit(1);
-			}
+/* FUNCTION DESCRIPTION: predicted_remaining
+* The predicted time left in the current CPU burst of a process: the predicted burst length less what
+* it has already run of this burst, never more than its remaining CPU time
+*/
+long long predicted_remaining(proc_t p){
+    int remaining = p->predicted_burst - p->current_burst;
+    if(remaining < 0) remaining = 0;
+    if(remaining > p->cpu_time_remaining) remaining = p->cpu_time_remaining;
+    return remaining;
+}
 
-			mm(argv[1],argv[2], memory_partition);
-			break;
+/* FUNCTION DESCRIPTION: sjf
+* Shortest Job First algorith implimentation, or Shortest Remaining Time First when preemptive.
+* The length of the next CPU burst of a process is not known to the scheduler, it is predicted by
+* exponential averaging of the bursts observed so far, starting from its io_frequency (or its total
+* CPU time when it does no io). The ready processes are kept in a heap ordered by predicted remaining time.
+* When preemptive, a process arriving or returning from io with a shorter prediction than what
+* remains of the running process preempts it.
+*/
+void sjf(char *input_file, char *output_file, bool preemptive) 
+{
+	int cpu_clock, avg_wt=0, avg_tt=0, proc_count=0;
+	bool simulation_completed = false;
+	node_t new_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
+    node_t running = NULL;
+    struct ready_heap ready_heap = { NULL, 0, 0, 0 };
+
+    // Process meta data should be read from a text file
+    printf("%s Scheduler for %s\n", preemptive ? "SRTF" : "SJF", input_file);
+    new_list = read_proc_from_file(input_file);
+
+    // The first prediction uses what the process tells us about its io pattern
+    for(node = new_list; node != NULL; node = node->next){
+        node->p->predicted_burst = (node->p->io_time_remaining > 0 && node->p->io_time_remaining < node->p->total_cpu_time) ? node->p->io_time_remaining : node->p->total_cpu_time;
+    }
+
+	//open output file and write heading to file
+	FILE *file = fopen(output_file, "w");
+    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
+
+    // Simulation loop
+    for(cpu_clock=0; simulation_completed==false && cpu_clock<clock_limit; cpu_clock++) 
+    {
+    	// Advance all the io timers for processes in waiting state
+        node = waiting_list;
+        while(node != NULL){
+            node->p->io_time_remaining --;
+            if(node->p->io_time_remaining == 0){
+                // This process is ready, it should change states from waiting to ready
+                // Update the time of next io event to the frequency of its occurance
+                // add it to the ready heap and remove it from waiting list
+                node->p->s = STATE_READY;
+                node->p->io_time_remaining = next_cpu_burst(node->p);
+
+                temp = node->next;
+                remove_node(&waiting_list, node);
+                heap_push(&ready_heap, node, predicted_remaining(node->p));
+                fprintf(file, "%d,%d,%s,%s\n", cpu_clock, node->p->pid, STATES[STATE_WAITING], STATES[STATE_READY]);
+
+                node = temp;
+            } else {
+                node = node->next;
+            }
+        }
+
+    	// Check if any of the items in new queue should be moved to the ready heap
+        node = new_list;
+        while(node!= NULL) {
+            // If the program has arrived change its state and add it to ready heap
+            if(node->p->arrival_time == cpu_clock){
+                node->p->s = STATE_READY;
+
+                temp = node->next;
+                remove_node(&new_list, node);
+                heap_push(&ready_heap, node, predicted_remaining(node->p));
+                fprintf(file,"%d,%d,%s,%s\n", cpu_clock, node->p->pid, STATES[STATE_NEW], STATES[STATE_READY]);
+                
+                node = temp;
+            } else {
+                node = node->next;
+            }
+        } 
+
+        // Make sure the CPU is running the process with the shortest predicted burst
+        if(running == NULL){
+            running = heap_pop(&ready_heap);
+            if(running != NULL){
+                running->p->s = STATE_RUNNING;
+                fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING]);
+            }
+        } 
+        else {
+            // if it is then remove the time step from remaining time until process completetion and next io event
+            running->p->cpu_time_remaining --;
+            running->p->io_time_remaining --;
+            running->p->current_burst ++;
+            
+            if(running->p->cpu_time_remaining == 0){
+                // The process is finished running, terminate it
+                running->p->s = STATE_TERMINATED;
+                terminated = push_node(terminated,running);
+                fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_TERMINATED]);
+                
+                // Calculate waiting and turnaround time
+                running->p->turnaround_time=cpu_clock-running->p->arrival_time;
+                running->p->wait_time=running->p->turnaround_time-running->p->total_cpu_time;
+
+                running = NULL;
+            } 
+            else if(running->p->io_time_remaining == 0){
+                // The process is blocked by io, update the timer and set state to waiting
+                // The burst that just ended refines the prediction of the next one
+                running->p->predicted_burst = (PREDICTION_WEIGHT*running->p->current_burst + (100-PREDICTION_WEIGHT)*running->p->predicted_burst)/100;
+                running->p->current_burst = 0;
+                running->p->io_time_remaining = next_io_burst(running->p);
+                running->p->s = STATE_WAITING;
+                waiting_list = push_node(waiting_list,running);
+                fprintf(file,"%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_WAITING]);
+
+                running = NULL;
+            }
+
+            if(running == NULL){
+                running = heap_pop(&ready_heap);
+                if(running != NULL){
+                    running->p->s = STATE_RUNNING;
+                    fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING]);
+                }
+            }
+            else if(preemptive && ready_heap.count > 0 && ready_heap.entries[0].key < predicted_remaining(running->p)){
+                // A process that arrived or returned from io is predicted to finish sooner, preempt
+                running->p->s = STATE_READY;
+                heap_push(&ready_heap, running, predicted_remaining(running->p));
+                fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_READY]);
+
+                running = heap_pop(&ready_heap);
+                running->p->s = STATE_RUNNING;
+                fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING]);
+            }
+        }
+
+        // The simulation is completed when all the queues are empty, in otherwords, all programs have run to completion
+        simulation_completed = (ready_heap.count == 0) && (new_list == NULL) && (waiting_list == NULL) && (running == NULL);
+    }
+
+    // Close the output file
+    fclose(file);
+
+    // Output average time
+    node = terminated;
+    while(node!= NULL) {
+        avg_wt +=node->p->wait_time;
+        avg_tt +=node->p->turnaround_time;
+        proc_count++;
+        node=node->next;
+    } 
+    printf("Average waiting time: %2.f, Average turnaround time: %2.f\n\n", (avg_wt*1.0)/proc_count, (avg_tt*1.0)/proc_count);
+
+    // The simulation is done, all the nodes are in the terminated list, free them
+    free(ready_heap.entries);
+    clean_up(terminated);
+}
+
+// The work handed to one simulation thread: every workload partition with index thread, thread+threads, ...
+struct partition_job
+{
+    node_t *lists;
+    node_t *terminated;
+    FILE **logs;
+    int count;
+    int thread, threads;
+    int time_quantum;
+};
+
+/* FUNCTION DESCRIPTION: simulate_partitions
+* Thread body, runs fcfs_run (time quantum 0) or rr_run over each partition assigned to this thread
+*/
+void *simulate_partitions(void *arg){
+    struct partition_job *job = (struct partition_job *) arg;
+
+    for(int i = job->thread; i < job->count; i += job->threads){
+        if(job->time_quantum > 0) job->terminated[i] = rr_run(job->lists[i], job->logs[i], job->time_quantum);
+        else job->terminated[i] = fcfs_run(job->lists[i], job->logs[i]);
+    }
+    return NULL;
+}
+
+/* FUNCTION DESCRIPTION: merge_partition_logs
+* Merges the transition logs of the partitions into file ordered by time. Transitions at the same time
+* are taken in partition order and a partition's own transitions keep their order, so the output does
+* not depend on how the partitions were spread over threads.
+* A heap of the partitions ordered by the time of their next transition keeps each step O(log n)
+*/
+void merge_partition_logs(FILE **logs, int count, FILE *file){
+    int MAXCHAR = 256;
+    char (*rows)[MAXCHAR] = malloc(count*sizeof(*rows));
+    long long *keys = malloc(count*sizeof(long long));
+    int *heap = malloc(count*sizeof(int));
+    int heap_count = 0, i, child, top, entry;
+
+    // The key of a partition's next row is its time then partition index, which is unique
+    for(int part = 0; part < count; part++){
+        rewind(logs[part]);
+        if(fgets(rows[part], MAXCHAR, logs[part]) == NULL) continue;
+        keys[part] = atoll(rows[part])*count + part;
+        for(i = heap_count++; i > 0 && keys[heap[(i-1)/2]] > keys[part]; i = (i-1)/2) heap[i] = heap[(i-1)/2];
+        heap[i] = part;
+    }
+
+    while(heap_count > 0){
+        top = heap[0];
+        fputs(rows[top], file);
+
+        // Replace the top with the partition's next row, or drop the partition when its log is done
+        if(fgets(rows[top], MAXCHAR, logs[top]) != NULL){
+            keys[top] = atoll(rows[top])*count + top;
+            entry = top;
+        } else {
+            entry = heap[--heap_count];
+        }
+        for(i = 0; (child = 2*i+1) < heap_count; i = child){
+            if(child+1 < heap_count && keys[heap[child+1]] < keys[heap[child]]) child++;
+            if(keys[heap[child]] >= keys[entry]) break;
+            heap[i] = heap[child];
+        }
+        if(heap_count > 0) heap[i] = entry;
+    }
+
+    free(rows);
+    free(keys);
+    free(heap);
+}
+
+/* FUNCTION DESCRIPTION: partitioned
+* Splits the workload by its Tenant (or Floor) column into partitions that never share a CPU and
+* simulates each with its own queues, FCFS when time_quantum is 0 and RR otherwise.
+* Partitions are spread over one thread per core, each writing its own temporary log, and the logs are
+* merged by time into output_file so the result is the same for any number of threads.
+*/
+void partitioned(char *input_file, char *output_file, int time_quantum) 
+{
+	int avg_wt=0, avg_tt=0, proc_count=0, count=0, capacity=0, threads, i;
+	bool inserted;
+	node_t new_list = NULL, node, next;
+    node_t *lists = NULL, *tails = NULL;
+    struct key_index index = { NULL, NULL, 0, 0 };
+
+    // Process meta data should be read from a text file
+    printf("Partitioned %s Scheduler for %s\n", time_quantum > 0 ? "RR" : "FCFS", input_file);
+    new_list = read_proc_from_file(input_file);
+
+    // Split the list by partition key, partitions are numbered in order of first appearance.
+    // A hash index of key to partition finds the partition and a tail pointer appends to it,
+    // so the split is linear in the number of processes
+    for(node = new_list; node != NULL; node = next){
+        next = node->next;
+        node->next = NULL;
+
+        i = find_or_insert_key(&index, node->p->partition_key, &inserted);
+        if(inserted){
+            if(i == capacity){
+                capacity = capacity ? capacity*2 : 16;
+                lists = (node_t *) realloc(lists, capacity*sizeof(node_t));
+                tails = (node_t *) realloc(tails, capacity*sizeof(node_t));
+            }
+            lists[i] = tails[i] = NULL;
+        }
+        if(tails[i] == NULL) lists[i] = node;
+        else tails[i]->next = node;
+        tails[i] = node;
+    }
+    count = index.count;
+    free(index.slots);
+    free(tails);
+
+    struct partition_job *jobs;
+    node_t *terminated = (node_t *) calloc(count, sizeof(node_t));
+    FILE **logs = (FILE **) malloc(count*sizeof(FILE *));
+    for(i=0; i<count; i++) {
+        logs[i] = tmpfile();
+        if(logs[i] == NULL){
+            printf("Error! Could not create a temporary log for partition %d\n", index.keys[i]);
+            exit(1);
+        }
+    }
+
+    threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads > count) threads = count;
+    if(threads < 1) threads = 1;
+    printf("Simulating %d partitions on %d threads\n", count, threads);
+
+    pthread_t *thread_ids = (pthread_t *) malloc(threads*sizeof(pthread_t));
+    jobs = (struct partition_job *) malloc(threads*sizeof(struct partition_job));
+    for(i=0; i<threads; i++){
+        jobs[i].lists = lists;
+        jobs[i].terminated = terminated;
+        jobs[i].logs = logs;
+        jobs[i].count = count;
+        jobs[i].thread = i;
+        jobs[i].threads = threads;
+        jobs[i].time_quantum = time_quantum;
+        pthread_create(&thread_ids[i], NULL, simulate_partitions, &jobs[i]);
+    }
+    for(i=0; i<threads; i++) pthread_join(thread_ids[i], NULL);
+
+	//open output file and write heading to file
+	FILE *file = fopen(output_file, "w");
+    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
+    merge_partition_logs(logs, count, file);
+    fclose(file);
+
+    // Output average time
+    for(i=0; i<count; i++){
+        fclose(logs[i]);
+        node = terminated[i];
+        while(node!= NULL) {
+            avg_wt +=node->p->wait_time;
+            avg_tt +=node->p->turnaround_time;
+            proc_count++;
+            node=node->next;
+        }
+        clean_up(terminated[i]);
+    }
+    printf("Average waiting time: %2.f, Average turnaround time: %2.f\n\n", (avg_wt*1.0)/proc_count, (avg_tt*1.0)/proc_count);
+
+    free(lists);
+    free(index.keys);
+    free(terminated);
+    free(logs);
+    free(thread_ids);
+    free(jobs);
+}
+
+// The scheduling policies the specialized kernels are generated for, POLICY_MM is first fit FCFS over memory partitions
+enum POLICY {
+    POLICY_FCFS,
+    POLICY_PRIORITY,
+    POLICY_RR,
+    POLICY_MM
+};
+static const char *POLICIES[] = { "FCFS", "Priority", "RR", "MM" };
+
+// What a kernel models on top of the scheduling, MODE_ENERGY and MODE_OVERHEAD are not generated for POLICY_MM
+enum KERNEL_MODE {
+    MODE_PLAIN,
+    MODE_ENERGY,
+    MODE_OVERHEAD
+};
+
+// A power model of the CPU, P-states are listed fastest first and C-states shallowest first
+#define MAX_POWER_STATES 8
+#define GOVERNOR_ONDEMAND -1
+struct power_model
+{
+    int p_states;
+    int speed[MAX_POWER_STATES];                // Percent of the full frequency, the work done per millisecond
+    double active_power[MAX_POWER_STATES];      // Watts drawn while running in the P-state
+    int transition_latency[MAX_POWER_STATES];   // Milliseconds the CPU stalls when switching to the P-state
+    int c_states;
+    double idle_power[MAX_POWER_STATES];        // Watts drawn while idle in the C-state
+    int exit_latency[MAX_POWER_STATES];         // Milliseconds the CPU stalls when woken from the C-state
+    int target_residency[MAX_POWER_STATES];     // Milliseconds of idleness before the C-state is entered
+    int governor;                               // The P-state to run in, or GOVERNOR_ONDEMAND
+};
+
+// The energy a kernel run used, energies are in millijoules (watts times milliseconds)
+struct energy_stats
+{
+    double busy_energy;
+    double idle_energy;
+    int p_residency[MAX_POWER_STATES];
+    int c_residency[MAX_POWER_STATES];
+    int stalled;
+    int p_transitions;
+    int wakeups;
+};
+
+// The power state the simulated CPU is in
+struct cpu_power
+{
+    int p_state;
+    int c_state;
+    int idle_run;
+    int stall;
+    int credit;
+};
+
+/* FUNCTION DESCRIPTION: power_step
+* Accounts the last millisecond of the CPU against the power model.
+* An idle CPU sinks into the deepest C-state whose target residency its idle run has reached.
+* A busy CPU first pays the exit latency of the C-state it wakes from and the transition latency of
+* any P-state change the governor makes, then does speed percent of a millisecond of work.
+* The ondemand governor runs at the fastest P-state while processes wait in the ready queue and at the slowest otherwise.
+* The return value is true if a full millisecond of work was done, the running process then advances one step
+*/
+static inline bool power_step(struct power_model *model, struct energy_stats *stats, struct cpu_power *cpu, bool busy, bool demand){
+    int target;
+
+    if(!busy){
+        cpu->idle_run++;
+        cpu->credit = 0;
+        while(cpu->c_state+1 < model->c_states && cpu->idle_run >= model->target_residency[cpu->c_state+1]) cpu->c_state++;
+        stats->idle_energy += model->idle_power[cpu->c_state];
+        stats->c_residency[cpu->c_state]++;
+        return false;
+    }
+
+    if(cpu->idle_run > 0){
+        cpu->stall += model->exit_latency[cpu->c_state];
+        stats->wakeups++;
+        cpu->idle_run = 0;
+        cpu->c_state = 0;
+    }
+
+    target = model->governor != GOVERNOR_ONDEMAND ? model->governor : (demand ? 0 : model->p_states-1);
+    if(target != cpu->p_state){
+        cpu->p_state = target;
+        cpu->stall += model->transition_latency[target];
+        stats->p_transitions++;
+    }
+    stats->busy_energy += model->active_power[cpu->p_state];
+    stats->p_residency[cpu->p_state]++;
+
+    if(cpu->stall > 0){
+        cpu->stall--;
+        stats->stalled++;
+        return false;
+    }
+    cpu->credit += model->speed[cpu->p_state];
+    if(cpu->credit < 100) return false;
+    cpu->credit -= 100;
+    return true;
+}
+
+// The cost of giving the CPU to a process: a fixed context switch plus a cache warm-up penalty that grows
+// with the time the process was away, from nothing to warmup once it has been away for decay milliseconds
+struct switch_model
+{
+    int switch_cost;
+    int warmup;
+    int decay;
+};
+
+// The time a kernel run lost to dispatching processes
+struct overhead_stats
+{
+    int switches;
+    int switch_time;
+    int warmup_time;
+};
+
+/* FUNCTION DESCRIPTION: charge_switch
+* Charges the dispatch of p to the CPU, last is the process that ran before it (NULL for none).
+* A process that never ran pays the full warm-up, one that was the last to run finds the cache as it left it.
+* The CPU stalls for the switch cost plus the warm-up, the return value is the warm-up
+*/
+static inline int charge_switch(struct switch_model *model, struct overhead_stats *stats, proc_t p, proc_t last, int cpu_clock, int *stall){
+    int warmup, absence;
+
+    if(p == last) warmup = 0;
+    else if(p->last_run < 0) warmup = model->warmup;
+    else {
+        absence = cpu_clock - p->last_run;
+        warmup = (absence >= model->decay) ? model->warmup : model->warmup*absence/model->decay;
+    }
+    *stall = model->switch_cost + warmup;
+    stats->switches++;
+    stats->switch_time += model->switch_cost;
+    stats->warmup_time += warmup;
+    return warmup;
+}
+
+// The run time parameters of a kernel, power is NULL unless the kernel models energy and switching
+// is NULL unless it models dispatch overhead
+struct sim_config
+{
+    int time_quantum;
+    Partition *memory_partition;
+    struct power_model *power;
+    struct energy_stats *energy;
+    struct switch_model *switching;
+    struct overhead_stats *overhead;
+};
+
+/* FUNCTION DESCRIPTION: next_arrival
+* Returns the earliest arrival time in list that is at or after cpu_clock, or INT_MAX if there is none
+*/
+int next_arrival(node_t list, int cpu_clock){
+    int earliest = INT_MAX;
+    for(; list != NULL; list = list->next){
+        if(list->p->arrival_time >= cpu_clock && list->p->arrival_time < earliest) earliest = list->p->arrival_time;
+    }
+    return earliest;
+}
+
+/* FUNCTION DESCRIPTION: sim_kernel
+* The simulation loop of fcfs, priority, rr and mm folded into one body, transition for transition the same.
+* policy, io, log and mode are compile time constants in every caller (see DEFINE_KERNEL) so the compiler
+* generates a separate loop for each combination with the branches that do not apply removed:
+*    -io false drops the waiting list and io timers, for workloads where no process ever blocks
+*    -log false drops all the formatting and writing of transitions, only the times are computed
+*    -policy POLICY_MM replaces the single CPU with the memory partitions of mm
+* The new list is only scanned at the times a process arrives instead of every millisecond.
+*    -mode MODE_ENERGY accounts every millisecond against config->power, the running process only
+*     advances in the milliseconds power_step reports a full millisecond of work for
+*    -mode MODE_OVERHEAD stalls the CPU after every dispatch for the cost charge_switch charges, the
+*     READY to RUNNING transitions then have the switch cost and the warm-up as two more columns
+* In either modelling mode the rr quantum is enforced, a process that used it goes to the back of the ready queue.
+* The return value is the list of terminated processes
+*/
+static inline __attribute__((always_inline))
+node_t sim_kernel(node_t new_list, FILE *file, struct sim_config *config, enum POLICY policy, bool io, bool log, enum KERNEL_MODE mode)
+{
+    const bool energy = mode == MODE_ENERGY, overhead = mode == MODE_OVERHEAD;
+	int cpu_clock, temp_quantum=config->time_quantum, arrival, total_memory_used=0, total_partition_memory_used=0;
+    int switch_stall = 0, warmup = 0;
+    proc_t last = NULL;
+    // The modelling kernels weigh every dispatch against what running costs, so unlike priority() and rr()
+    // they put a preempted process back on the ready list and enforce the quantum
+    const bool requeue = mode != MODE_PLAIN;
+	bool simulation_completed = false, progress = true;
+	node_t ready_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
+    node_t running = NULL;
+    Partition *memory_partition = config->memory_partition;
+    struct cpu_power cpu = { 0, 0, 0, 0, 0 };
+
+    if(energy && config->power->governor != GOVERNOR_ONDEMAND) cpu.p_state = config->power->governor;
+    arrival = next_arrival(new_list, 0);
+
+    // Simulation loop
+    for(cpu_clock=0; simulation_completed==false && cpu_clock<clock_limit; cpu_clock++) 
+    {
+        // The process running at the start of this step ran for the last millisecond
+        if(energy && cpu_clock > 0) progress = power_step(config->power, config->energy, &cpu, running != NULL, ready_list != NULL);
+        if(overhead){
+            progress = running == NULL || switch_stall == 0;
+            if(!progress) switch_stall--;
+        }
+
+        if(policy == POLICY_PRIORITY && running!=NULL && ready_list!=NULL) {
+            // The plain kernels preempt the same as priority(), including the lists it is pushed to, so the output matches it
+            node_t next = get_highest_priority(ready_list);
+            if(next->p->priority>running->p->priority) {
+                remove_node(&ready_list, next);
+                if(requeue) {
+                    running->p->s = STATE_READY;
+                    ready_list = push_node(ready_list,running);
+                    if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_READY]);
+                }
+                else {
+                    running->p->s = STATE_WAITING;
+                    terminated = push_node(waiting_list,running);
+                    if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_WAITING]);
+                }
+
+                running = next;
+                running->p->s = STATE_RUNNING;
+                if(overhead){
+                    warmup = charge_switch(config->switching, config->overhead, running->p, last, cpu_clock, &switch_stall);
+                    last = running->p;
+                }
+                if(log && overhead) fprintf(file, "%d,%d,%s,%s,%d,%d\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING], config->switching->switch_cost, warmup);
+                else if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING]);
+            }
+        }
+
+        if(policy == POLICY_RR && !requeue && running !=NULL && running->p->cpu_time_remaining!=0 && running->p->io_time_remaining == 0 && temp_quantum==0) {
+            // Same quantum expiry as rr(), including the lists it is pushed to, so the output matches it
+            running->p->s = STATE_READY;
+            terminated = push_node(ready_list,running);
+            if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_READY]);
+            running=NULL;
+        }
+
+        if(policy == POLICY_RR && requeue && running !=NULL && temp_quantum<=0) {
+            // The process goes to the back of the ready queue, or keeps the CPU for another quantum if nothing else is ready
+            if(ready_list == NULL) temp_quantum=config->time_quantum;
+            else {
+                running->p->s = STATE_READY;
+                ready_list = push_node(ready_list,running);
+                if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_READY]);
+                running=NULL;
+            }
+        }
+
+        // Advance all the io timers for processes in waiting state
+        node = io ? waiting_list : NULL;
+        while(node != NULL){
+            node->p->io_time_remaining --;
+            if(node->p->io_time_remaining == 0){
+                node->p->s = STATE_READY;
+                node->p->io_time_remaining = next_cpu_burst(node->p);
+
+                temp = node->next;
+                remove_node(&waiting_list, node);
+                ready_list = push_node(ready_list, node);
+                if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, node->p->pid, STATES[STATE_WAITING], STATES[STATE_READY]);
+
+                node = temp;
+            } else {
+                node = node->next;
+            }
+        }
+
+        // Move the processes arriving now from the new list to the ready queue
+        if(cpu_clock == arrival){
+            node = new_list;
+            while(node!= NULL) {
+                if(node->p->arrival_time == cpu_clock){
+                    node->p->s = STATE_READY;
+
+                    temp = node->next;
+                    remove_node(&new_list, node);
+                    ready_list = push_node(ready_list, node);
+                    if(log) fprintf(file,"%d,%d,%s,%s\n", cpu_clock, node->p->pid, STATES[STATE_NEW], STATES[STATE_READY]);
+
+                    node = temp;
+                } else {
+                    node = node->next;
+                }
+            }
+            arrival = next_arrival(new_list, cpu_clock+1);
+        }
+
+        if(policy == POLICY_MM){
+            // Every free partition takes the first ready process that fits, every occupied one runs its process
+            for(int i=0; i<4; i++) {
+                if(memory_partition[i].occupied==false) {
+                    if(ready_list!=NULL) {
+                        running=get_first_fit(ready_list, memory_partition[i].size);
+                        if(running==NULL) continue;
+
+                        running->p->s = STATE_RUNNING;
+                        remove_node(&ready_list, running);
+
+                        memory_partition[i].occupied=true;
+                        memory_partition[i].node_process=running;
+                        total_partition_memory_used+=memory_partition[i].size;
+                        total_memory_used+=running->p->memory_required;
+
+                        if(log) fprintf(file,"%d,%d,%s,%s,%d,%d,%d,%s%d\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING],
+                            total_memory_used,1000-total_memory_used,1000-total_partition_memory_used , "Partition ", memory_partition[i].size);
+                    } else {running=NULL;}
+                }
+                else{
+                    running = memory_partition[i].node_process;
+                    running->p->cpu_time_remaining --;
+                    if(io) running->p->io_time_remaining --;
+
+                    if(running->p->cpu_time_remaining == 0){
+                        running->p->s = STATE_TERMINATED;
+                        terminated = push_node(terminated,running);
+                        total_partition_memory_used-=memory_partition[i].size;
+                        total_memory_used-=running->p->memory_required;
+                        memory_partition[i].occupied=false;
+                        if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_TERMINATED]);
+
+                        running->p->turnaround_time=cpu_clock-running->p->arrival_time;
+                        running->p->wait_time=running->p->turnaround_time-running->p->total_cpu_time;
+                        running=NULL;
+                    } 
+                    else if(io && running->p->io_time_remaining == 0){
+                        running->p->io_time_remaining = next_io_burst(running->p);
+                        running->p->s = STATE_WAITING;
+                        total_partition_memory_used-=memory_partition[i].size;
+                        total_memory_used-=running->p->memory_required;
+                        memory_partition[i].occupied=false;
+                        waiting_list = push_node(waiting_list,running);
+                        if(log) fprintf(file,"%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_WAITING]);
+                        running=NULL;
+                    }
+                }
+            }
+
+            simulation_completed = (ready_list == NULL) && (new_list == NULL) && (waiting_list == NULL);
+            for(int i=0; i<4; i++) {
+                if(memory_partition[i].occupied==true) {simulation_completed=false;}
+            }
+            continue;
+        }
+
+        // Make sure the CPU is running a process
+        if(running == NULL){
+            if(ready_list!=NULL){
+                running = (policy == POLICY_PRIORITY) ? get_highest_priority(ready_list) : ready_list;
+                running->p->s = STATE_RUNNING;
+                remove_node(&ready_list, running);
+                if(policy == POLICY_RR) temp_quantum=config->time_quantum;
+                if(overhead){
+                    warmup = charge_switch(config->switching, config->overhead, running->p, last, cpu_clock, &switch_stall);
+                    last = running->p;
+                }
+                if(log && overhead) fprintf(file, "%d,%d,%s,%s,%d,%d\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING], config->switching->switch_cost, warmup);
+                else if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING]);
+            }
+        } 
+        else if((!energy && !overhead) || progress) {
+            // if it is then remove the time step from remaining time until process completetion and next io event
+            running->p->cpu_time_remaining --;
+            if(overhead) running->p->last_run = cpu_clock;
+            if(io) running->p->io_time_remaining --;
+            if(policy == POLICY_RR) temp_quantum--;
+
+            if(running->p->cpu_time_remaining == 0){
+                running->p->s = STATE_TERMINATED;
+                terminated = push_node(terminated,running);
+                if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_TERMINATED]);
+
+                running->p->turnaround_time=cpu_clock-running->p->arrival_time;
+                running->p->wait_time=running->p->turnaround_time-running->p->total_cpu_time;
+                running = NULL;
+            } 
+            else if(io && running->p->io_time_remaining == 0){
+                running->p->io_time_remaining = next_io_burst(running->p);
+                running->p->s = STATE_WAITING;
+                waiting_list = push_node(waiting_list,running);
+                if(log) fprintf(file,"%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_WAITING]);
+                running = NULL;
+            }
+
+            // The CPU was given up, dispatch the next process in the same millisecond
+            if(running == NULL && ready_list!=NULL){
+                running = (policy == POLICY_PRIORITY) ? get_highest_priority(ready_list) : ready_list;
+                running->p->s = STATE_RUNNING;
+                remove_node(&ready_list, running);
+                if(policy == POLICY_RR) temp_quantum=config->time_quantum;
+                if(overhead){
+                    warmup = charge_switch(config->switching, config->overhead, running->p, last, cpu_clock, &switch_stall);
+                    last = running->p;
+                }
+                if(log && overhead) fprintf(file, "%d,%d,%s,%s,%d,%d\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING], config->switching->switch_cost, warmup);
+                else if(log) fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING]);
+            }
+        }
+
+        // The simulation is completed when all the queues are empty, in otherwords, all programs have run to completion
+        simulation_completed = (ready_list == NULL) && (new_list == NULL) && (waiting_list == NULL) && (running == NULL);
+    }
+
+    return terminated;
+}
+
+// A kernel is sim_kernel specialized for one combination of policy, io, logging and mode
+typedef node_t (*kernel_t)(node_t new_list, FILE *file, struct sim_config *config);
+
+#define DEFINE_KERNEL(name, policy, io, log, mode) \
+    static node_t name(node_t new_list, FILE *file, struct sim_config *config) { \
+        return sim_kernel(new_list, file, config, policy, io, log, mode); \
+    }
+
+// The kernels of every mode for one combination of policy, io and logging
+#define DEFINE_KERNELS(name, policy, io, log) \
+    DEFINE_KERNEL(name,          policy, io, log, MODE_PLAIN) \
+    DEFINE_KERNEL(name##_energy,   policy, io, log, MODE_ENERGY) \
+    DEFINE_KERNEL(name##_overhead, policy, io, log, MODE_OVERHEAD)
+#define KERNEL_MODES(name) { name, name##_energy, name##_overhead }
+
+DEFINE_KERNELS(kernel_fcfs,               POLICY_FCFS,     false, false)
+DEFINE_KERNELS(kernel_fcfs_log,           POLICY_FCFS,     false, true)
+DEFINE_KERNELS(kernel_fcfs_io,            POLICY_FCFS,     true,  false)
+DEFINE_KERNELS(kernel_fcfs_io_log,        POLICY_FCFS,     true,  true)
+DEFINE_KERNELS(kernel_priority,           POLICY_PRIORITY, false, false)
+DEFINE_KERNELS(kernel_priority_log,       POLICY_PRIORITY, false, true)
+DEFINE_KERNELS(kernel_priority_io,        POLICY_PRIORITY, true,  false)
+DEFINE_KERNELS(kernel_priority_io_log,    POLICY_PRIORITY, true,  true)
+DEFINE_KERNELS(kernel_rr,                 POLICY_RR,       false, false)
+DEFINE_KERNELS(kernel_rr_log,             POLICY_RR,       false, true)
+DEFINE_KERNELS(kernel_rr_io,              POLICY_RR,       true,  false)
+DEFINE_KERNELS(kernel_rr_io_log,          POLICY_RR,       true,  true)
+DEFINE_KERNEL(kernel_mm,                  POLICY_MM,       false, false, MODE_PLAIN)
+DEFINE_KERNEL(kernel_mm_log,              POLICY_MM,       false, true,  MODE_PLAIN)
+DEFINE_KERNEL(kernel_mm_io,               POLICY_MM,       true,  false, MODE_PLAIN)
+DEFINE_KERNEL(kernel_mm_io_log,           POLICY_MM,       true,  true,  MODE_PLAIN)
+
+// The kernels indexed by [policy][io][log][mode], mm runs its partitions at the same time so it is only plain
+static const kernel_t KERNELS[4][2][2][3] = {
+    { { KERNEL_MODES(kernel_fcfs),     KERNEL_MODES(kernel_fcfs_log) },     { KERNEL_MODES(kernel_fcfs_io),     KERNEL_MODES(kernel_fcfs_io_log) } },
+    { { KERNEL_MODES(kernel_priority), KERNEL_MODES(kernel_priority_log) }, { KERNEL_MODES(kernel_priority_io), KERNEL_MODES(kernel_priority_io_log) } },
+    { { KERNEL_MODES(kernel_rr),       KERNEL_MODES(kernel_rr_log) },       { KERNEL_MODES(kernel_rr_io),       KERNEL_MODES(kernel_rr_io_log) } },
+    { { { kernel_mm, NULL, NULL },     { kernel_mm_log, NULL, NULL } },     { { kernel_mm_io, NULL, NULL },     { kernel_mm_io_log, NULL, NULL } } },
+};
+
+/* FUNCTION DESCRIPTION: uses_io
+* Returns true if any process in list can block on io. A process whose io timer starts negative
+* (io_frequency of -1) and that has no burst list never reaches 0 and never blocks.
+*/
+bool uses_io(node_t list){
+    for(; list != NULL; list = list->next){
+        if(list->p->io_time_remaining >= 0 || list->p->burst_count > 0) return true;
+    }
+    return false;
+}
+
+/* FUNCTION DESCRIPTION: select_kernel
+* Picks the kernel specialized for the policy, whether the workload does io, whether transitions are logged
+* and what it models
+*/
+kernel_t select_kernel(enum POLICY policy, node_t new_list, bool log, enum KERNEL_MODE mode){
+    return KERNELS[policy][uses_io(new_list)][log][mode];
+}
+
+/* FUNCTION DESCRIPTION: print_energy
+* Prints the energy a kernel run used, its energy-delay product and the time spent in every power state.
+* makespan is the time the last process finished in milliseconds
+*/
+void print_energy(struct power_model *model, struct energy_stats *stats, int makespan){
+    double joules = (stats->busy_energy + stats->idle_energy) / 1000.0;
+
+    printf("Energy: %.3f J (busy %.3f J, idle %.3f J), makespan %d ms, energy-delay product %.3f J*s\n", joules,
+        stats->busy_energy / 1000.0, stats->idle_energy / 1000.0, makespan, joules * makespan / 1000.0);
+    for(int i=0; i<model->p_states; i++) printf("P%d (%d%%): %d ms  ", i, model->speed[i], stats->p_residency[i]);
+    printf("\n");
+    for(int i=0; i<model->c_states; i++) printf("C%d: %d ms  ", i, stats->c_residency[i]);
+    printf("\n");
+    printf("P-state transitions: %d, wakeups: %d, stalled: %d ms\n", stats->p_transitions, stats->wakeups, stats->stalled);
+}
+
+/* FUNCTION DESCRIPTION: print_overhead
+* Prints the time a kernel run lost to context switches and cache warm-up and the throughput that was left.
+* makespan is the time the last process finished in milliseconds
+*/
+void print_overhead(struct overhead_stats *stats, int makespan, int proc_count){
+    int lost = stats->switch_time + stats->warmup_time;
+
+    printf("Dispatches: %d, context switch time: %d ms, warm-up time: %d ms\n", stats->switches, stats->switch_time, stats->warmup_time);
+    printf("Overhead: %d of %d ms (%.1f%%), throughput %.2f processes per second\n", lost, makespan,
+        makespan > 0 ? lost*100.0/makespan : 0.0, makespan > 0 ? proc_count*1000.0/makespan : 0.0);
+}
+
+/* FUNCTION DESCRIPTION: specialized
+* Runs fcfs, priority, rr or mm on the kernel specialized for the workload, with the same output.
+* An output file of "-" turns logging off and only the average times are reported.
+* With config->power set the energy modelling kernel is used and the energy of the run is reported as well,
+* otherwise with config->switching set the dispatch overhead kernel is used and the time lost to it reported.
+*/
+void specialized(char *input_file, char *output_file, enum POLICY policy, struct sim_config *config) 
+{
+	int avg_wt=0, avg_tt=0, proc_count=0, makespan=0;
+	node_t new_list = NULL, terminated = NULL, node;
+    bool log = strcmp(output_file, "-") != 0;
+    FILE *file = NULL;
+
+    // Process meta data should be read from a text file
+    printf("%s Scheduler (specialized kernel) for %s\n", POLICIES[policy], input_file);
+    new_list = read_proc_from_file(input_file);
+
+    enum KERNEL_MODE mode = config->power != NULL ? MODE_ENERGY : config->switching != NULL ? MODE_OVERHEAD : MODE_PLAIN;
+    kernel_t kernel = select_kernel(policy, new_list, log, mode);
+    printf("Kernel: %s, io %s, logging %s, energy model %s, dispatch overhead %s\n", POLICIES[policy], uses_io(new_list) ? "on" : "off", log ? "on" : "off",
+        mode == MODE_ENERGY ? "on" : "off", mode == MODE_OVERHEAD ? "on" : "off");
+
+	//open output file and write heading to file
+    if(log){
+        file = fopen(output_file, "w");
+        if(policy == POLICY_MM) fprintf(file,"%s, %s, %s, %s, %s, %s, %s, %s\n","Time of transition","PID","Old State","New State", "Total Memory Used", "Total Memory Free", "Total Usable Memory", "Partition Size");
+        else if(mode == MODE_OVERHEAD) fprintf(file,"%s, %s, %s, %s, %s, %s\n","Time of transition","PID","Old State","New State", "Switch Cost", "Warm-up Penalty");
+        else fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
+    }
+
+    terminated = kernel(new_list, file, config);
+
+    // Close the output file
+    if(log) fclose(file);
+
+    // Output average time
+    node = terminated;
+    while(node!= NULL) {
+        avg_wt +=node->p->wait_time;
+        avg_tt +=node->p->turnaround_time;
+        proc_count++;
+        if(node->p->arrival_time+node->p->turnaround_time > makespan) makespan = node->p->arrival_time+node->p->turnaround_time;
+        node=node->next;
+    } 
+    if(mode == MODE_ENERGY) print_energy(config->power, config->energy, makespan);
+    else if(mode == MODE_OVERHEAD) print_overhead(config->overhead, makespan, proc_count);
+    printf("Average waiting time: %2.f, Average turnaround time: %2.f\n\n", (avg_wt*1.0)/proc_count, (avg_tt*1.0)/proc_count);
+
+    // The simulation is done, all the nodes are in the terminated list, free them
+    clean_up(terminated);
+}
+
+// A structure containing one row of a transition log, this is what fcfs, priority, rr and mm write
+// The memory columns are only present on the READY to RUNNING rows of mm, and the switch cost and warm-up
+// columns on the READY to RUNNING rows of the dispatch overhead kernels, they are -1 otherwise
+struct transition
+{
+    int time;
+    int pid;
+    int old_state;
+    int new_state;
+    int memory_used;
+    int memory_free;
+    int usable_memory;
+    int partition_size;
+    int switch_cost;
+    int warmup;
+};
+
+// The binary transition log starts with this magic and a version, followed by packed transition records.
+// The version and every field of a record are 32 bit little endian integers, whatever the host.
+// Version 1 records stop before the switch cost and warm-up fields
+#define TLOG_MAGIC "KSTL"
+#define TLOG_VERSION 2
+#define TLOG_FIELDS 10
+#define TLOG_V1_FIELDS 8
+#define TLOG_CHUNK 4096
+#define HISTOGRAM_BUCKETS 32
+#define TOTAL_MEMORY 1000
+
+/* FUNCTION DESCRIPTION: parse_int
+* Parses a (possibly negative) integer at *cursor and advances the cursor past it.
+* Leading spaces and any non digit prefix such as "Partition " are skipped.
+* The return value is the integer, or -1 if the field has no digits
+*/
+static int parse_int(char **cursor){
+    char *c = *cursor;
+    int value = 0, sign = 1;
+
+    while(*c != '\0' && *c != ',' && *c != '-' && (*c < '0' || *c > '9')) c++;
+    if(*c == '-'){
+        sign = -1;
+        c++;
+    }
+    if(*c < '0' || *c > '9'){
+        *cursor = c;
+        return -1;
+    }
+    while(*c >= '0' && *c <= '9'){
+        value = value*10 + (*c - '0');
+        c++;
+    }
+    *cursor = c;
+    return sign*value;
+}
+
+/* FUNCTION DESCRIPTION: parse_state
+* Maps a state name in the transition log back to its enum value and advances the cursor past it.
+* Only the leading characters are compared, READY and RUNNING are told apart by their second letter.
+* The return value is the state or -1 if the name is not recognised
+*/
+static int parse_state(char **cursor){
+    char *c = *cursor;
+    int state = -1;
+
+    while(*c == ' ') c++;
+    switch(c[0]) {
+    case 'N': state = STATE_NEW; break;
+    case 'R': state = (c[1] == 'E') ? STATE_READY : STATE_RUNNING; break;
+    case 'W': state = STATE_WAITING; break;
+    case 'T': state = STATE_TERMINATED; break;
+    }
+    while(*c != '\0' && *c != ',') c++;
+    *cursor = c;
+    return state;
+}
+
+/* FUNCTION DESCRIPTION: valid_transition
+* Returns true if the pid and both states of t can be used as table keys and indices
+*/
+static bool valid_transition(struct transition *t){
+    return t->pid >= 0 && t->pid < INT_MAX
+        && t->old_state >= STATE_NEW && t->old_state <= STATE_TERMINATED
+        && t->new_state >= STATE_NEW && t->new_state <= STATE_TERMINATED;
+}
+
+/* FUNCTION DESCRIPTION: parse_transition
+* Parses one CSV row of a transition log into t.
+* The return value is true if the row is a transition, false for the header or a malformed row
+*/
+bool parse_transition(char *row, struct transition *t){
+    char *c = row;
+    int extra[4], columns;
+
+    if(*c < '0' || *c > '9') return false;
+    t->time = parse_int(&c);
+    if(*c++ != ',') return false;
+    t->pid = parse_int(&c);
+    if(*c++ != ',') return false;
+    t->old_state = parse_state(&c);
+    if(*c++ != ',') return false;
+    t->new_state = parse_state(&c);
+    if(!valid_transition(t)) return false;
+
+    // The four memory columns of mm, or the two switch cost and warm-up columns of the dispatch overhead kernels
+    t->memory_used = t->memory_free = t->usable_memory = t->partition_size = -1;
+    t->switch_cost = t->warmup = -1;
+    for(columns = 0; columns < 4 && *c == ','; columns++){
+        c++;
+        extra[columns] = parse_int(&c);
+    }
+    if(columns == 2){
+        t->switch_cost = extra[0];
+        t->warmup = extra[1];
+    } else if(columns == 4){
+        t->memory_used = extra[0];
+        t->memory_free = extra[1];
+        t->usable_memory = extra[2];
+        t->partition_size = extra[3];
+    }
+    return true;
+}
+
+/* FUNCTION DESCRIPTION: put_le32 / get_le32
+* Store and load a 32 bit integer as 4 little endian bytes
+*/
+static void put_le32(unsigned char *bytes, int value){
+    unsigned int u = (unsigned int) value;
+    bytes[0] = u & 0xff;
+    bytes[1] = (u >> 8) & 0xff;
+    bytes[2] = (u >> 16) & 0xff;
+    bytes[3] = (u >> 24) & 0xff;
+}
+
+static int get_le32(unsigned char *bytes){
+    return (int) ((unsigned int) bytes[0] | (unsigned int) bytes[1] << 8 | (unsigned int) bytes[2] << 16 | (unsigned int) bytes[3] << 24);
+}
+
+/* FUNCTION DESCRIPTION: encode_transition / decode_transition
+* Convert a transition to and from its binary record, the fields in declaration order
+*/
+static void encode_transition(unsigned char *record, struct transition *t){
+    int fields[TLOG_FIELDS] = { t->time, t->pid, t->old_state, t->new_state, t->memory_used, t->memory_free,
+        t->usable_memory, t->partition_size, t->switch_cost, t->warmup };
+    for(int i=0; i<TLOG_FIELDS; i++) put_le32(record + 4*i, fields[i]);
+}
+
+static void decode_transition(unsigned char *record, struct transition *t){
+    t->time = get_le32(record);
+    t->pid = get_le32(record + 4);
+    t->old_state = get_le32(record + 8);
+    t->new_state = get_le32(record + 12);
+    t->memory_used = get_le32(record + 16);
+    t->memory_free = get_le32(record + 20);
+    t->usable_memory = get_le32(record + 24);
+    t->partition_size = get_le32(record + 28);
+    t->switch_cost = get_le32(record + 32);
+    t->warmup = get_le32(record + 36);
+}
+
+// A reader over a transition log that hides whether the log is CSV or binary
+struct transition_reader
+{
+    FILE *f;
+    bool binary;
+    char row[256];
+    unsigned char record[4*TLOG_FIELDS];
+    int fields;
+};
+
+/* FUNCTION DESCRIPTION: open_transition_log
+* Opens a transition log and detects its format from the first bytes, binary logs of version 1 and 2 are read.
+* The return value is true if the file could be opened
+*/
+bool open_transition_log(struct transition_reader *r, char *input_file){
+    char magic[4];
+    unsigned char version[4];
+
+    r->f = fopen(input_file, "rb");
+    if(r->f == NULL) return false;
+
+    r->binary = fread(magic, 1, 4, r->f) == 4 && memcmp(magic, TLOG_MAGIC, 4) == 0;
+    if(r->binary){
+        if(fread(version, 1, 4, r->f) != 4) memset(version, 0, sizeof(version));
+        if(get_le32(version) == 1) r->fields = TLOG_V1_FIELDS;
+        else if(get_le32(version) == TLOG_VERSION) r->fields = TLOG_FIELDS;
+        else {
+            printf("Error! Unsupported binary transition log version\n");
+            fclose(r->f);
+            return false;
+        }
+    } else {
+        rewind(r->f);
+    }
+    return true;
+}
+
+/* FUNCTION DESCRIPTION: read_transitions
+* Fills buffer with up to max transitions from the log.
+* Binary logs are read a record at a time, CSV logs a row at a time skipping the header.
+* Records with a negative pid or an unknown state are dropped in both formats.
+* The return value is the number of transitions read, 0 at the end of the log
+*/
+int read_transitions(struct transition_reader *r, struct transition *buffer, int max){
+    int count = 0;
+
+    if(r->binary){
+        // Fields a version 1 record does not have read as -1, as in a CSV row without them
+        memset(r->record, 0xff, sizeof(r->record));
+        while(count < max && fread(r->record, 4, r->fields, r->f) == (size_t) r->fields){
+            decode_transition(r->record, &buffer[count]);
+            if(valid_transition(&buffer[count])) count++;
+        }
+        return count;
+    }
+
+    while(count < max && fgets(r->row, sizeof(r->row), r->f) != NULL){
+        if(parse_transition(r->row, &buffer[count])) count++;
+    }
+    return count;
+}
+
+// The state each process was last seen in, and the totals accumulated for it so far
+struct residency
+{
+    int pid;
+    int state;
+    int since;
+    int first_seen;
+    int transitions;
+    int memory;
+    int partition;
+    long long time_in[STATE_TERMINATED];
+};
+
+// The residencies in order of first appearance, with a hash index of pid to position in front of them
+struct residency_table
+{
+    struct residency *entries;
+    int capacity;
+    struct key_index index;
+};
+
+/* FUNCTION DESCRIPTION: lookup_residency
+* Finds the residency of pid, adding a new one if the pid has not been seen.
+* The return value is a pointer to the residency, valid until the next lookup
+*/
+struct residency *lookup_residency(struct residency_table *table, int pid, int time){
+    bool inserted;
+    int i = find_or_insert_key(&table->index, pid, &inserted);
+    struct residency *r;
+
+    if(inserted){
+        if(i == table->capacity){
+            table->capacity = table->capacity ? table->capacity*2 : 64;
+            table->entries = realloc(table->entries, table->capacity*sizeof(struct residency));
+        }
+        r = &table->entries[i];
+        memset(r, 0, sizeof(struct residency));
+        r->pid = pid;
+        r->state = STATE_NEW;
+        r->since = time;
+        r->first_seen = time;
+    }
+    return &table->entries[i];
+}
+
+/* FUNCTION DESCRIPTION: histogram_bucket
+* Bucket 0 holds zero length intervals, bucket k holds intervals in [2^(k-1), 2^k)
+*/
+static int histogram_bucket(int duration){
+    int bucket = 0;
+    while(duration > 0 && bucket < HISTOGRAM_BUCKETS-1){
+        duration >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/* FUNCTION DESCRIPTION: derive_output_name
+* Builds the name of a companion output file by replacing the .csv extension of base with suffix
+*/
+void derive_output_name(char *name, int size, char *base, char *suffix){
+    int length = strlen(base);
+    if(length > 4 && strcmp(base+length-4, ".csv") == 0) length -= 4;
+    snprintf(name, size, "%.*s%s", length, base, suffix);
+}
+
+/* FUNCTION DESCRIPTION: pack_transition_log
+* Converts a CSV transition log into the binary format so it can be analysed again without parsing
+*/
+void pack_transition_log(char *input_file, char *output_file)
+{
+    struct transition_reader reader;
+    struct transition *buffer;
+    unsigned char version[4], record[4*TLOG_FIELDS];
+    int count, i;
+    long long total = 0;
+
+    if(!open_transition_log(&reader, input_file)){
+        printf("Error! Could not open transition log %s\n", input_file);
+        exit(1);
+    }
+    FILE *file = fopen(output_file, "wb");
+    fwrite(TLOG_MAGIC, 1, 4, file);
+    put_le32(version, TLOG_VERSION);
+    fwrite(version, 1, 4, file);
+
+    buffer = malloc(TLOG_CHUNK*sizeof(struct transition));
+    while((count = read_transitions(&reader, buffer, TLOG_CHUNK)) > 0){
+        for(i=0; i<count; i++){
+            encode_transition(record, &buffer[i]);
+            fwrite(record, 1, sizeof(record), file);
+        }
+        total += count;
+    }
+    printf("Packed %lld transitions from %s into %s\n\n", total, input_file, output_file);
+
+    free(buffer);
+    fclose(reader.f);
+    fclose(file);
+}
+
+/* FUNCTION DESCRIPTION: write_residency
+* Writes the row of one process lifetime to the residency file
+*/
+static void write_residency(FILE *file, struct residency *r){
+    fprintf(file, "%d,%d,%d,%lld,%lld,%lld,%lld,%d\n", r->pid, r->first_seen, r->since,
+        r->time_in[STATE_NEW], r->time_in[STATE_READY], r->time_in[STATE_RUNNING], r->time_in[STATE_WAITING], r->transitions);
+}
+
+/* FUNCTION DESCRIPTION: analyze
+* Single streaming pass over a transition log (CSV or binary) producing:
+*    -output_file: per process time spent in each state, a pid that reappears after terminating starts a new row
+*    -<output>_histogram.csv: distribution of the length of each stay in a state
+*    -<output>_queue.csv: ready, running and waiting queue lengths (and memory use for mm logs) over time
+*    -<output>_gantt.csv: one row per interval a process spent in a state, for Gantt charts
+* For logs of the dispatch overhead kernels the time lost to context switches and cache warm-up is printed.
+* An output file ending in .bin packs the log into the binary format instead
+*/
+void analyze(char *input_file, char *output_file)
+{
+    struct transition_reader reader;
+    struct transition *buffer, *t;
+    struct residency_table table = { NULL, 0, { NULL, NULL, 0, 0 } };
+    struct residency *r;
+    long long histogram[STATE_TERMINATED][HISTOGRAM_BUCKETS] = {{0}};
+    int queue_length[STATE_TERMINATED+1] = {0};
+    int count, i, s, duration, last_time = -1, end_time = 0;
+    int memory_used = 0, partition_used = 0;
+    long long total = 0, dispatches = 0, switch_time = 0, warmup_time = 0;
+    bool memory_log = false;
+    char name[1024];
+
+    int length = strlen(output_file);
+    if(length > 4 && strcmp(output_file+length-4, ".bin") == 0){
+        pack_transition_log(input_file, output_file);
+        return;
+    }
+
+    printf("Transition log analysis for %s\n", input_file);
+    if(!open_transition_log(&reader, input_file)){
+        printf("Error! Could not open transition log %s\n", input_file);
+        exit(1);
+    }
+
+    FILE *file = fopen(output_file, "w");
+    fprintf(file, "%s, %s, %s, %s, %s, %s, %s, %s\n", "PID", "First Seen", "Last Transition", "New", "Ready", "Running", "Waiting", "Transitions");
+    derive_output_name(name, sizeof(name), output_file, "_queue.csv");
+    FILE *queue_file = fopen(name, "w");
+    derive_output_name(name, sizeof(name), output_file, "_gantt.csv");
+    FILE *gantt_file = fopen(name, "w");
+    fprintf(gantt_file, "%s, %s, %s, %s\n", "PID", "State", "Start", "End");
+
+    buffer = malloc(TLOG_CHUNK*sizeof(struct transition));
+    while((count = read_transitions(&reader, buffer, TLOG_CHUNK)) > 0){
+        // The queue file header depends on whether this is a mm log, which the first chunk tells us
+        if(total == 0){
+            for(i=0; i<count; i++) {
+                if(buffer[i].memory_used >= 0) memory_log = true;
+            }
+            if(memory_log) fprintf(queue_file, "%s, %s, %s, %s, %s, %s\n", "Time", "Ready", "Running", "Waiting", "Memory Used", "Partition Memory Used");
+            else fprintf(queue_file, "%s, %s, %s, %s\n", "Time", "Ready", "Running", "Waiting");
+        }
+
+        for(i=0; i<count; i++){
+            t = &buffer[i];
+
+            // The queue lengths are sampled once all the transitions of a time step have been applied
+            if(t->time != last_time && last_time >= 0){
+                if(memory_log) fprintf(queue_file, "%d,%d,%d,%d,%d,%d\n", last_time, queue_length[STATE_READY], queue_length[STATE_RUNNING], queue_length[STATE_WAITING], memory_used, partition_used);
+                else fprintf(queue_file, "%d,%d,%d,%d\n", last_time, queue_length[STATE_READY], queue_length[STATE_RUNNING], queue_length[STATE_WAITING]);
+            }
+            last_time = t->time;
+
+            r = lookup_residency(&table, t->pid, t->time);
+            if(r->state == STATE_TERMINATED){
+                // The pid was reused (as in merged partition logs), the terminated lifetime is complete
+                write_residency(file, r);
+                memset(r->time_in, 0, sizeof(r->time_in));
+                r->state = STATE_NEW;
+                r->since = r->first_seen = t->time;
+                r->transitions = r->memory = r->partition = 0;
+            }
+            s = r->state;
+            duration = t->time - r->since;
+            r->time_in[s] += duration;
+            histogram[s][histogram_bucket(duration)]++;
+            if(duration > 0) fprintf(gantt_file, "%d,%s,%d,%d\n", t->pid, STATES[s], r->since, t->time);
+            r->transitions++;
+            r->state = t->new_state;
+            r->since = t->time;
+
+            queue_length[t->old_state]--;
+            queue_length[t->new_state]++;
+
+            if(t->switch_cost >= 0){
+                dispatches++;
+                switch_time += t->switch_cost;
+                warmup_time += t->warmup;
+            }
+
+            // mm only logs the memory in use when a process is dispatched, the difference gives the process
+            // its share so it can be released again when the process leaves its partition
+            if(t->memory_used >= 0){
+                r->memory = t->memory_used - memory_used;
+                memory_used = t->memory_used;
+                if(t->usable_memory >= 0) {
+                    r->partition = (TOTAL_MEMORY - t->usable_memory) - partition_used;
+                    partition_used = TOTAL_MEMORY - t->usable_memory;
+                }
+            } else if(t->old_state == STATE_RUNNING && memory_log){
+                memory_used -= r->memory;
+                partition_used -= r->partition;
+                r->memory = r->partition = 0;
+            }
+        }
+        total += count;
+    }
+    if(last_time >= 0){
+        if(memory_log) fprintf(queue_file, "%d,%d,%d,%d,%d,%d\n", last_time, queue_length[STATE_READY], queue_length[STATE_RUNNING], queue_length[STATE_WAITING], memory_used, partition_used);
+        else fprintf(queue_file, "%d,%d,%d,%d\n", last_time, queue_length[STATE_READY], queue_length[STATE_RUNNING], queue_length[STATE_WAITING]);
+        end_time = last_time;
+    }
+
+    // Per process residency, processes that never terminated are charged up to the end of the log
+    for(i=0; i<table.index.count; i++){
+        r = &table.entries[i];
+        if(r->state != STATE_TERMINATED) r->time_in[r->state] += end_time - r->since;
+        write_residency(file, r);
+    }
+    fclose(file);
+
+    derive_output_name(name, sizeof(name), output_file, "_histogram.csv");
+    file = fopen(name, "w");
+    fprintf(file, "%s, %s, %s, %s\n", "State", "Duration From", "Duration To", "Count");
+    for(s=0; s<STATE_TERMINATED; s++){
+        for(i=0; i<HISTOGRAM_BUCKETS; i++){
+            if(histogram[s][i] == 0) continue;
+            fprintf(file, "%s,%lld,%lld,%lld\n", STATES[s], i ? 1LL<<(i-1) : 0, i ? (1LL<<i)-1 : 0, histogram[s][i]);
+        }
+    }
+    fclose(file);
+
+    if(dispatches > 0) printf("Dispatch overhead: %lld dispatches, %lld ms context switching, %lld ms cache warm-up\n", dispatches, switch_time, warmup_time);
+    printf("Analysed %lld transitions of %d processes\n\n", total, table.index.count);
+
+    free(buffer);
+    free(table.entries);
+    free(table.index.keys);
+    free(table.index.slots);
+    fclose(reader.f);
+    fclose(queue_file);
+    fclose(gantt_file);
+}
+
+// A task seen in a kernel scheduler trace, the times are in microseconds
+// running_since, runnable_since and sleeping_since are -1 while the task is not in that condition
+struct trace_task
+{
+    int pid;
+    int prio;
+    long long first_seen, last_seen;
+    long long running_since, runnable_since, sleeping_since;
+    long long cpu_time, io_time, wait_time, other_sleep_time;
+    int io_count, block_requests;
+    bool io_sleep;
+};
+
+// Tasks are kept in first seen order, with a hash index of pid to position in front of them
+struct trace_table
+{
+    struct trace_task *tasks;
+    int capacity;
+    struct key_index index;
+};
+
+/* FUNCTION DESCRIPTION: lookup_task
+* Finds the task with this pid, adding it if it has not been seen yet.
+* The return value is a pointer to the task, valid until the next lookup
+*/
+struct trace_task *lookup_task(struct trace_table *table, int pid, long long ts){
+    bool inserted;
+    int i = find_or_insert_key(&table->index, pid, &inserted);
+
+    if(!inserted) return &table->tasks[i];
+    if(i == table->capacity){
+        table->capacity = table->capacity ? table->capacity*2 : 1024;
+        table->tasks = realloc(table->tasks, table->capacity*sizeof(struct trace_task));
+    }
+    struct trace_task *task = &table->tasks[i];
+    memset(task, 0, sizeof(struct trace_task));
+    task->pid = pid;
+    task->prio = 120;
+    task->first_seen = task->last_seen = ts;
+    task->running_since = task->runnable_since = task->sleeping_since = -1;
+    return task;
+}
+
+/* FUNCTION DESCRIPTION: trace_field
+* Finds "key" in the event payload, where key must start a word, e.g. " pid=" does not match "prev_pid=".
+* The return value is a pointer to the value after the key or NULL if it is missing
+*/
+static char *trace_field(char *payload, char *key){
+    char *c = payload;
+    int length = strlen(key);
+
+    while((c = strstr(c, key)) != NULL){
+        if(c == payload || c[-1] == ' ') return c + length;
+        c += length;
+    }
+    return NULL;
+}
+
+/* FUNCTION DESCRIPTION: trace_timestamp
+* Finds the "seconds.microseconds:" timestamp token before the event name and converts it to microseconds.
+* The return value is the timestamp or -1 if the line has none
+*/
+static long long trace_timestamp(char *line, char *event){
+    char *c, *start;
+    long long seconds, micros;
+    int digits;
+
+    // Walk back over the tokens before the event until one looks like a timestamp
+    for(c = event; c > line; ){
+        while(c > line && c[-1] == ' ') c--;
+        start = c;
+        while(start > line && start[-1] != ' ') start--;
+        if(c > start && c[-1] == ':' && *start >= '0' && *start <= '9' && memchr(start, '.', c-start) != NULL){
+            seconds = 0;
+            micros = 0;
+            digits = 0;
+            for(c = start; *c != '.'; c++) seconds = seconds*10 + (*c - '0');
+            for(c++; *c >= '0' && *c <= '9'; c++) {
+                if(digits++ < 6) micros = micros*10 + (*c - '0');
+            }
+            for(; digits < 6; digits++) micros *= 10;
+            return seconds*1000000 + micros;
+        }
+        c = start;
+    }
+    return -1;
+}
+
+/* FUNCTION DESCRIPTION: trace_current_pid
+* The pid of the task the event was recorded in, "comm-pid [cpu]" for ftrace and "comm pid [cpu]" for perf script.
+* The return value is the pid or -1 if it can not be found
+*/
+static int trace_current_pid(char *line){
+    char *cpu = strstr(line, " [");
+    char *c;
+
+    if(cpu == NULL) return -1;
+    while(cpu > line && cpu[-1] == ' ') cpu--;
+    c = cpu;
+    while(c > line && c[-1] >= '0' && c[-1] <= '9') c--;
+    if(c == cpu) return -1;
+    return atoi(c);
+}
+
+/* FUNCTION DESCRIPTION: trace_run_until
+* Closes the current CPU burst of a running task at ts
+*/
+static void trace_run_until(struct trace_task *task, long long ts){
+    if(task->running_since >= 0){
+        task->cpu_time += ts - task->running_since;
+        task->running_since = -1;
+    }
+}
+
+/* FUNCTION DESCRIPTION: us_to_ms
+* Rounds a duration in microseconds to the nearest millisecond, never below 1
+*/
+static int us_to_ms(long long us){
+    long long ms = (us + 500)/1000;
+    return ms < 1 ? 1 : (int) ms;
+}
+
+/* FUNCTION DESCRIPTION: ingest_trace
+* Converts an ftrace or perf script text dump of the sched_switch, sched_wakeup(_new) and block_rq_issue
+* tracepoints into the 7 column CSV read by read_proc_from_file.
+* The trace is read one line at a time so memory only grows with the number of tasks, not the trace length.
+* For every task:
+*    -Arrival Time is when it was first seen, relative to the start of the trace
+*    -Total CPU Time is the sum of its time between being switched in and switched out
+*    -a switch out while sleeping followed by a wakeup is an I/O burst if the sleep is uninterruptible
+*     (prev_state D) or the task issued a block request since its last sleep. Other sleeps (timers, futexes,
+*     sockets) are not I/O and the CPU time either side of them is one burst.
+*     I/O Frequency is the average CPU burst and I/O Duration the average I/O sleep
+*    -Priority is 140 - the kernel prio, so higher is more important as in get_highest_priority
+*    -Memory Required is 0, scheduler traces have no memory information
+* The averages of what the kernel actually did are printed in the same format as the schedulers for comparison.
+* The sleeps that are not I/O have no place in the CSV, so they are left out of the kernel turnaround too
+*/
+void ingest_trace(char *input_file, char *output_file)
+{
+    int MAXCHAR = 4096;
+    char line[MAXCHAR];
+    char *event, *payload, *value;
+    struct trace_table table = { NULL, 0, { NULL, NULL, 0, 0 } };
+    struct trace_task *task;
+    long long ts, trace_start = -1, trace_end = 0, avg_wt = 0, avg_tt = 0, other_sleep = 0, lines = 0, events = 0;
+    int pid, i, bursts, io_frequency, io_duration;
+    enum { TRACE_SWITCH, TRACE_WAKEUP, TRACE_BLOCK } kind;
+
+    printf("Trace ingestion for %s\n", input_file);
+    FILE *f = fopen(input_file, "r");
+    if(f == NULL){
+        printf("Error! Could not open trace %s\n", input_file);
+        exit(1);
+    }
+
+    while(fgets(line, MAXCHAR, f) != NULL){
+        lines++;
+        if(line[0] == '#') continue;
+
+        // Find the event, perf script prefixes it with "sched:" or "block:" which the search skips over
+        if((event = strstr(line, "sched_switch:")) != NULL) kind = TRACE_SWITCH;
+        else if((event = strstr(line, "sched_wakeup_new:")) != NULL) kind = TRACE_WAKEUP;
+        else if((event = strstr(line, "sched_wakeup:")) != NULL) kind = TRACE_WAKEUP;
+        else if((event = strstr(line, "block_rq_issue:")) != NULL) kind = TRACE_BLOCK;
+        else continue;
+        payload = strchr(event, ':') + 1;
+
+        if(event > line && event[-1] == ':') {
+            while(event > line && event[-1] != ' ') event--;
+        }
+        ts = trace_timestamp(line, event);
+        if(ts < 0) continue;
+        if(trace_start < 0) trace_start = ts;
+        trace_end = ts;
+        events++;
+
+        if(kind == TRACE_SWITCH){
+            // prev_comm=a prev_pid=1 prev_prio=120 prev_state=S ==> next_comm=b next_pid=2 next_prio=120
+            if((value = trace_field(payload, "prev_pid=")) != NULL && (pid = atoi(value)) != 0){
+                task = lookup_task(&table, pid, ts);
+                task->last_seen = ts;
+                if((value = trace_field(payload, "prev_prio=")) != NULL) task->prio = atoi(value);
+                trace_run_until(task, ts);
+                value = trace_field(payload, "prev_state=");
+                if(value == NULL || *value == 'R'){
+                    // Preempted, the task is still runnable
+                    task->runnable_since = ts;
+                } else if(*value == 'X' || *value == 'Z'){
+                    // Exited
+                    task->sleeping_since = -1;
+                } else {
+                    task->sleeping_since = ts;
+                    task->io_sleep = *value == 'D' || task->block_requests > 0;
+                    task->block_requests = 0;
+                }
+            }
+            if((value = trace_field(payload, "next_pid=")) != NULL && (pid = atoi(value)) != 0){
+                task = lookup_task(&table, pid, ts);
+                task->last_seen = ts;
+                if((value = trace_field(payload, "next_prio=")) != NULL) task->prio = atoi(value);
+                if(task->runnable_since >= 0) task->wait_time += ts - task->runnable_since;
+                task->runnable_since = -1;
+                task->running_since = ts;
+            }
+        } else if(kind == TRACE_BLOCK){
+            if((pid = trace_current_pid(line)) > 0){
+                task = lookup_task(&table, pid, ts);
+                task->block_requests++;
+            }
+        } else {
+            // sched_wakeup and sched_wakeup_new: comm=a pid=1 prio=120 target_cpu=000
+            if((value = trace_field(payload, "pid=")) != NULL && (pid = atoi(value)) != 0){
+                task = lookup_task(&table, pid, ts);
+                task->last_seen = ts;
+                if((value = trace_field(payload, "prio=")) != NULL) task->prio = atoi(value);
+                if(task->sleeping_since >= 0 && task->io_sleep){
+                    task->io_time += ts - task->sleeping_since;
+                    task->io_count++;
+                } else if(task->sleeping_since >= 0) {
+                    task->other_sleep_time += ts - task->sleeping_since;
+                }
+                task->sleeping_since = -1;
+                if(task->running_since < 0 && task->runnable_since < 0) task->runnable_since = ts;
+            }
+        }
+    }
+    fclose(f);
+
+    FILE *file = fopen(output_file, "w");
+    fprintf(file, "Pid,Arrival Time,Total CPU Time,I/O Frequency,I/O Duration, Priority, Memory Required\n");
+    for(i=0; i<table.index.count; i++){
+        task = &table.tasks[i];
+        trace_run_until(task, trace_end);
+
+        // A task still asleep on I/O at the end of the trace finished its last burst with that sleep
+        bursts = task->io_count + (task->sleeping_since >= 0 && task->io_sleep ? 0 : 1);
+        if(task->io_count > 0){
+            io_frequency = us_to_ms(task->cpu_time / (bursts > 0 ? bursts : 1));
+            io_duration = us_to_ms(task->io_time / task->io_count);
+        } else {
+            io_frequency = io_duration = -1;
+        }
+        fprintf(file, "%d,%lld,%d,%d,%d,%d,%d\n", task->pid, (task->first_seen - trace_start + 500)/1000, us_to_ms(task->cpu_time),
+            io_frequency, io_duration, 140 - task->prio, 0);
+
+        avg_wt += task->wait_time;
+        avg_tt += task->last_seen - task->first_seen - task->other_sleep_time;
+        other_sleep += task->other_sleep_time;
+    }
+    fclose(file);
+
+    printf("Read %lld events from %lld lines, %d tasks over %lldms\n", events, lines, table.index.count, (trace_end - trace_start)/1000);
+    if(table.index.count > 0) {
+        printf("Traced kernel turnaround excludes %lldms of sleep that is not I/O, which the CSV does not model\n", other_sleep/1000);
+        printf("Traced kernel average waiting time: %2.f, Average turnaround time: %2.f\n\n", avg_wt/1000.0/table.index.count, avg_tt/1000.0/table.index.count);
+    }
+
+    free(table.tasks);
+    free(table.index.keys);
+    free(table.index.slots);
+}
+
+// The clock limit used while verifying, generated workloads finish long before it unless a loop never ends
+#define VERIFY_CLOCK_LIMIT 20000
+
+/* FUNCTION DESCRIPTION: random_next
+* splitmix64, a small seeded generator that gives the same sequence on every platform unlike rand()
+*/
+unsigned long long random_next(unsigned long long *state){
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* FUNCTION DESCRIPTION: random_range
+* Returns a random integer in [low, high]
+*/
+int random_range(unsigned long long *state, int low, int high){
+    return low + (int) (random_next(state) % (unsigned long long) (high - low + 1));
+}
+
+/* FUNCTION DESCRIPTION: copy_list
+* Makes a copy of the processes in list, in the same order, that a simulation can consume without
+* touching the original. The nodes and processes are allocated as two blocks so free_copy can release
+* them whatever lists the simulation left them in.
+* The return value is the head of the copy
+*/
+node_t copy_list(node_t list){
+    node_t node, nodes;
+    proc_t procs;
+    int count = 0, i = 0;
+
+    for(node = list; node != NULL; node = node->next) count++;
+    if(count == 0) return NULL;
+
+    nodes = (node_t) malloc(count*sizeof(struct node));
+    procs = (proc_t) malloc(count*sizeof(struct process));
+    for(node = list; node != NULL; node = node->next, i++){
+        procs[i] = *node->p;
+        nodes[i].p = &procs[i];
+        nodes[i].next = (i+1 < count) ? &nodes[i+1] : NULL;
+    }
+    return nodes;
+}
+
+/* FUNCTION DESCRIPTION: free_copy
+* Frees a list made by copy_list, copy must be the head copy_list returned
+*/
+void free_copy(node_t copy){
+    if(copy == NULL) return;
+    free(copy->p);
+    free(copy);
+}
+
+/* FUNCTION DESCRIPTION: generate_workload
+* Generates count random processes from the seeded generator, a quarter of them with burst lists.
+* Every process fits in a partition of max_memory so mm always makes progress.
+* The return value is a list of the new processes
+*/
+node_t generate_workload(unsigned long long *state, int count, int max_memory){
+    node_t list = NULL;
+    proc_t proc;
+    int io_frequency, bursts;
+
+    for(int pid = 1; pid <= count; pid++){
+        io_frequency = random_range(state, 0, 2) == 0 ? -1 : random_range(state, 1, 15);
+        proc = create_proc(pid, random_range(state, 0, 4*count), random_range(state, 1, 40), io_frequency,
+            io_frequency < 0 ? -1 : random_range(state, 1, 10), random_range(state, 1, 5), random_range(state, 1, max_memory));
+
+        if(random_range(state, 0, 3) == 0){
+            proc->burst_offset = burst_arena.count;
+            proc->burst_count = 0;
+            bursts = 2*random_range(state, 0, 4) + 1;
+            for(int i = 0; i < bursts; i++) {
+                add_burst(random_range(state, 1, 12));
+                proc->burst_count++;
+            }
+            proc->io_time_remaining = next_cpu_burst(proc);
+        }
+        list = push_node(list, create_node(proc));
+    }
+    return list;
+}
+
+/* FUNCTION DESCRIPTION: write_workload
+* Writes a workload in the input format, with a Bursts column, so a failing case can be replayed
+*/
+void write_workload(node_t list, FILE *file){
+    fprintf(file, "Pid,Arrival Time,Total CPU Time,I/O Frequency,I/O Duration, Priority, Memory Required, Bursts\n");
+    for(; list != NULL; list = list->next){
+        proc_t p = list->p;
+        fprintf(file, "%d,%d,%d,%d,%d,%d,%d,", p->pid, p->arrival_time, p->total_cpu_time, p->io_frequency, p->io_duration, p->priority, p->memory_required);
+        for(int i = 0; i < p->burst_count; i++) fprintf(file, "%s%d", i ? " " : "", burst_arena.bursts[p->burst_offset + i]);
+        fprintf(file, "\n");
+    }
+}
+
+/* FUNCTION DESCRIPTION: write_queue_state
+* Replays the first rows transitions of log and writes which processes are new, ready (in the order
+* they became ready), running, waiting and terminated at that point
+*/
+void write_queue_state(FILE *log, long rows, node_t workload, FILE *report){
+    int MAXCHAR = 256;
+    char row[MAXCHAR];
+    struct transition t;
+    node_t node;
+    int count = 0, i, s, seq = 0;
+    long read = 0;
+
+    for(node = workload; node != NULL; node = node->next) count++;
+    int *state = (int *) malloc((count+1)*sizeof(int));
+    int *ready_seq = (int *) malloc((count+1)*sizeof(int));
+    for(i=0; i<count; i++) state[i] = STATE_NEW;
+
+    rewind(log);
+    fgets(row, MAXCHAR, log);
+    while(read < rows && fgets(row, MAXCHAR, log) != NULL){
+        read++;
+        if(!parse_transition(row, &t)) continue;
+        for(i = 0, node = workload; node != NULL && node->p->pid != t.pid; node = node->next, i++);
+        if(node == NULL) continue;
+        state[i] = t.new_state;
+        if(t.new_state == STATE_READY) ready_seq[i] = seq++;
+    }
+
+    for(s = STATE_NEW; s <= STATE_TERMINATED; s++){
+        fprintf(report, "    %-10s:", STATES[s]);
+        if(s == STATE_READY){
+            // Selection by ready order, the lists are small
+            for(int next = 0; next < seq; next++){
+                for(i = 0; i < count; i++) {
+                    if(state[i] == STATE_READY && ready_seq[i] == next) break;
+                }
+                if(i == count) continue;
+                for(node = workload; i-- > 0; node = node->next);
+                fprintf(report, " %d", node->p->pid);
+            }
+        } else {
+            for(i = 0, node = workload; node != NULL; node = node->next, i++) {
+                if(state[i] == s) fprintf(report, " %d", node->p->pid);
+            }
+        }
+        fprintf(report, "\n");
+    }
+
+    free(state);
+    free(ready_seq);
+}
+
+/* FUNCTION DESCRIPTION: run_reference
+* Runs the original per millisecond loop of a policy
+*/
+node_t run_reference(enum POLICY policy, node_t list, FILE *file, struct sim_config *config){
+    switch(policy){
+    case POLICY_FCFS: return fcfs_run(list, file);
+    case POLICY_PRIORITY: return priority_run(list, file);
+    case POLICY_RR: return rr_run(list, file, config->time_quantum);
+    default: return mm_run(list, file, config->memory_partition);
+    }
+}
+
+/* FUNCTION DESCRIPTION: verify_case
+* Runs a workload through the reference loop and the specialized kernel, with and without logging,
+* and compares the transitions row by row and the wait and turnaround time of every process.
+* The first divergence is written to report along with the queues each side had at that point.
+* unfinished is counted up when the reference run left a process that never terminated.
+* The return value is true if both agree
+*/
+bool verify_case(node_t workload, enum POLICY policy, struct sim_config *config, char *name, FILE *report, int *unfinished){
+    int MAXCHAR = 256;
+    char expected[MAXCHAR], actual[MAXCHAR];
+    Partition reference_partition[4], kernel_partition[4];
+    struct sim_config reference_config = *config, kernel_config = *config;
+    node_t reference_list = copy_list(workload), kernel_list = copy_list(workload), quiet_list = copy_list(workload);
+    node_t reference_done, kernel_done, quiet_done, a, b;
+    node_t reference_copy = reference_list;
+    FILE *reference_log = tmpfile(), *kernel_log = tmpfile();
+    bool ok = true, have_expected, have_actual;
+    long row = 0;
+    int i;
+
+    // mm marks its partitions occupied, every run gets its own
+    memcpy(reference_partition, config->memory_partition, sizeof(reference_partition));
+    reference_config.memory_partition = reference_partition;
+    kernel_config.memory_partition = kernel_partition;
+
+    fprintf(reference_log, "header\n");
+    fprintf(kernel_log, "header\n");
+    reference_done = run_reference(policy, reference_list, reference_log, &reference_config);
+    memcpy(kernel_partition, config->memory_partition, sizeof(kernel_partition));
+    kernel_done = select_kernel(policy, kernel_list, true, MODE_PLAIN)(kernel_list, kernel_log, &kernel_config);
+    memcpy(kernel_partition, config->memory_partition, sizeof(kernel_partition));
+    quiet_done = select_kernel(policy, quiet_list, false, MODE_PLAIN)(quiet_list, NULL, &kernel_config);
+
+    // The processes of a copy are one block, in workload order, whatever lists they ended up in
+    for(a = workload, i = 0; a != NULL; a = a->next, i++) {
+        if(reference_copy->p[i].s != STATE_TERMINATED) {
+            (*unfinished)++;
+            break;
+        }
+    }
+
+    // Transition streams
+    rewind(reference_log);
+    rewind(kernel_log);
+    while(ok){
+        have_expected = fgets(expected, MAXCHAR, reference_log) != NULL;
+        have_actual = fgets(actual, MAXCHAR, kernel_log) != NULL;
+        if(!have_expected && !have_actual) break;
+        if(have_expected && have_actual && strcmp(expected, actual) == 0) {
+            row++;
+            continue;
+        }
+
+        ok = false;
+        fprintf(report, "DIVERGENCE in %s, %s (time quantum %d), transition %ld\n", name, POLICIES[policy], config->time_quantum, row);
+        fprintf(report, "  reference: %s", have_expected ? expected : "<end of log>\n");
+        fprintf(report, "  kernel:    %s", have_actual ? actual : "<end of log>\n");
+        fprintf(report, "  reference queues before it:\n");
+        write_queue_state(reference_log, row-1, workload, report);
+        fprintf(report, "  kernel queues before it:\n");
+        write_queue_state(kernel_log, row-1, workload, report);
+    }
+
+    // Wait and turnaround times, in termination order, of both kernels
+    for(a = reference_done, b = kernel_done; ok && (a != NULL || b != NULL); a = a->next, b = b->next){
+        if(a == NULL || b == NULL || a->p->pid != b->p->pid || a->p->wait_time != b->p->wait_time || a->p->turnaround_time != b->p->turnaround_time){
+            ok = false;
+            fprintf(report, "DIVERGENCE in %s, %s: terminated processes differ at PID %d\n", name, POLICIES[policy], a ? a->p->pid : b->p->pid);
+        }
+    }
+    for(a = reference_done, b = quiet_done; ok && (a != NULL || b != NULL); a = a->next, b = b->next){
+        if(a == NULL || b == NULL || a->p->pid != b->p->pid || a->p->wait_time != b->p->wait_time || a->p->turnaround_time != b->p->turnaround_time){
+            ok = false;
+            fprintf(report, "DIVERGENCE in %s, %s: terminated processes of the kernel without logging differ at PID %d\n", name, POLICIES[policy], a ? a->p->pid : b->p->pid);
+        }
+    }
+
+    if(!ok) {
+        fprintf(report, "  workload:\n");
+        write_workload(workload, report);
+    }
+
+    fclose(reference_log);
+    fclose(kernel_log);
+    free_copy(reference_copy);
+    free_copy(kernel_list);
+    free_copy(quiet_list);
+    return ok;
+}
+
+/* FUNCTION DESCRIPTION: verify
+* Differential check of the specialized kernels against the original fcfs, priority, rr and mm loops.
+* With an input file every policy is verified on it, with the time quantum and partitions given
+* (by default 10 and 500 250 150 100). With "fuzz" as the input file, iterations random workloads
+* generated from seed are verified with random time quanta and partitions.
+* Simulations are stopped at VERIFY_CLOCK_LIMIT, both sides are still compared up to that point but a case
+* the reference did not finish is counted as unfinished rather than verified.
+* The report, with the first divergence if there is one, is written to output_file
+*/
+void verify(char *input_file, char *output_file, struct sim_config *config, int iterations, unsigned long long seed) 
+{
+    char name[64];
+    node_t workload;
+    Partition memory_partition[4];
+    struct sim_config fuzz_config = { 0, memory_partition, NULL, NULL, NULL, NULL };
+    unsigned long long state = seed;
+    int cases = 0, unfinished = 0, largest, remaining;
+    bool ok = true, fuzz = strcmp(input_file, "fuzz") == 0;
+    enum POLICY policy;
+
+    FILE *report = fopen(output_file, "w");
+    clock_limit = VERIFY_CLOCK_LIMIT;
+
+    if(!fuzz){
+        printf("Verifying the specialized kernels on %s\n", input_file);
+        workload = read_proc_from_file(input_file);
+        for(policy = POLICY_FCFS; ok && policy <= POLICY_MM; policy = (enum POLICY) (policy+1)){
+            ok = verify_case(workload, policy, config, input_file, report, &unfinished);
+            cases++;
+        }
+        clean_up(workload);
+    } else {
+        printf("Verifying the specialized kernels on %d random workloads, seed %llu\n", iterations, seed);
+        for(int i = 0; ok && i < iterations; i++){
+            // Random partitions adding up to at most 1000, in random order
+            remaining = 1000;
+            largest = 0;
+            for(int j = 0; j < 4; j++){
+                memory_partition[j].size = random_range(&state, 0, remaining/(4-j));
+                remaining -= memory_partition[j].size;
+                if(memory_partition[j].size > largest) largest = memory_partition[j].size;
+                memory_partition[j].occupied = false;
+            }
+            if(largest == 0) memory_partition[0].size = largest = 1;
+            fuzz_config.time_quantum = random_range(&state, 0, 20);
+
+            workload = generate_workload(&state, random_range(&state, 1, 20), largest);
+            snprintf(name, sizeof(name), "fuzz workload %d", i);
+            for(policy = POLICY_FCFS; ok && policy <= POLICY_MM; policy = (enum POLICY) (policy+1)){
+                ok = verify_case(workload, policy, &fuzz_config, name, report, &unfinished);
+                cases++;
+            }
+            clean_up(workload);
+        }
+    }
+
+    clock_limit = INT_MAX;
+    fprintf(report, "%s: %d cases verified, %d cases unfinished at the clock limit of %d and only matched up to it\n", ok ? "PASS" : "FAIL", cases-unfinished, unfinished, VERIFY_CLOCK_LIMIT);
+    printf("%s: %d cases verified, %d cases unfinished at the clock limit of %d and only matched up to it\n\n", ok ? "PASS" : "FAIL", cases-unfinished, unfinished, VERIFY_CLOCK_LIMIT);
+    fclose(report);
+    if(!ok) exit(1);
+}
+
+// Stride of a process with a single ticket, a process with n tickets advances its pass by STRIDE1/n per millisecond
+#define STRIDE1 (1<<20)
+
+// Per process bookkeeping of the proportional share schedulers, indexed by the slot of the process
+struct share
+{
+    node_t node;
+    int tickets;
+    long long stride, pass;
+    double entitled, active_since;
+    int received;
+};
+
+/* FUNCTION DESCRIPTION: fenwick_add
+* Adds delta to entry i of a Fenwick tree of n entries (stored 1 based), O(log n)
+*/
+void fenwick_add(long long *tree, int n, int i, long long delta){
+    for(i++; i <= n; i += i & -i) tree[i] += delta;
+}
+
+/* FUNCTION DESCRIPTION: fenwick_find
+* Returns the first entry whose prefix sum is greater than target, so drawing target uniformly
+* from [0, total) picks each entry with probability proportional to its value, O(log n)
+*/
+int fenwick_find(long long *tree, int n, long long target){
+    int i = 0, step = 1;
+
+    while(step*2 <= n) step *= 2;
+    for(; step > 0; step /= 2){
+        if(i + step <= n && tree[i+step] <= target){
+            i += step;
+            target -= tree[i];
+        }
+    }
+    return i;
+}
+
+/* FUNCTION DESCRIPTION: proportional
+* Lottery and Stride proportional share algorith implimentation, the priority column is the number of tickets.
+* The running process is rescheduled when it blocks, terminates or has run for time_quantum ms.
+*    -Lottery: the ready tickets are kept in a Fenwick tree and each dispatch draws one from the seeded generator
+*    -Stride: the ready processes are kept in a heap ordered by pass, the process with the lowest pass runs and
+*     its pass advances by its stride for every millisecond it ran. A process becoming ready is brought up to
+*     the pass of the last dispatch so time spent blocked does not turn into credit.
+* At the end every process's received CPU time is compared with what its tickets entitled it to, that is its
+* share of the tickets of the ready and running processes over each millisecond it was ready or running.
+*/
+void proportional(char *input_file, char *output_file, int time_quantum, bool lottery, unsigned long long seed) 
+{
+	int cpu_clock, temp_quantum=0, ran=0, avg_wt=0, avg_tt=0, proc_count=0, count=0, ready_count=0, i;
+	bool simulation_completed = false;
+	node_t new_list = NULL, waiting_list = NULL, terminated = NULL, temp, node;
+    node_t running = NULL;
+    struct ready_heap ready_heap = { NULL, 0, 0, 0 };
+    struct share *shares, *share;
+    long long *tree, active_tickets = 0, global_pass = 0;
+    double share_clock = 0;
+    unsigned long long state = seed;
+
+    if(time_quantum < 1) time_quantum = 1;
+
+    // Process meta data should be read from a text file
+    printf("%s Scheduler for %s\n", lottery ? "Lottery" : "Stride", input_file);
+    new_list = read_proc_from_file(input_file);
+
+    for(node = new_list; node != NULL; node = node->next) node->p->slot = count++;
+    shares = (struct share *) calloc(count, sizeof(struct share));
+    tree = (long long *) calloc(count+1, sizeof(long long));
+    for(node = new_list; node != NULL; node = node->next){
+        share = &shares[node->p->slot];
+        share->node = node;
+        share->tickets = node->p->priority > 0 ? node->p->priority : 1;
+        share->stride = STRIDE1 / share->tickets;
+    }
+
+	//open output file and write heading to file
+	FILE *file = fopen(output_file, "w");
+    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
+
+    // Simulation loop
+    for(cpu_clock=0; simulation_completed==false && cpu_clock<clock_limit; cpu_clock++) 
+    {
+        // Every process ready or running over the last millisecond was entitled to its share of the active tickets
+        if(active_tickets > 0) share_clock += 1.0/active_tickets;
+
+    	// Advance all the io timers for processes in waiting state
+        node = waiting_list;
+        while(node != NULL){
+            node->p->io_time_remaining --;
+            if(node->p->io_time_remaining == 0){
+                node->p->s = STATE_READY;
+                node->p->io_time_remaining = next_cpu_burst(node->p);
+
+                temp = node->next;
+                remove_node(&waiting_list, node);
+                share = &shares[node->p->slot];
+                share->active_since = share_clock;
+                active_tickets += share->tickets;
+                if(lottery) fenwick_add(tree, count, node->p->slot, share->tickets);
+                else {
+                    if(share->pass < global_pass) share->pass = global_pass;
+                    heap_push(&ready_heap, node, share->pass);
+                }
+                ready_count++;
+                fprintf(file, "%d,%d,%s,%s\n", cpu_clock, node->p->pid, STATES[STATE_WAITING], STATES[STATE_READY]);
+
+                node = temp;
+            } else {
+                node = node->next;
+            }
+        }
+
+    	// Check if any of the items in new queue should be moved to the ready queue
+        node = new_list;
+        while(node!= NULL) {
+            if(node->p->arrival_time == cpu_clock){
+                node->p->s = STATE_READY;
+
+                temp = node->next;
+                remove_node(&new_list, node);
+                share = &shares[node->p->slot];
+                share->active_since = share_clock;
+                active_tickets += share->tickets;
+                if(lottery) fenwick_add(tree, count, node->p->slot, share->tickets);
+                else {
+                    share->pass = global_pass;
+                    heap_push(&ready_heap, node, share->pass);
+                }
+                ready_count++;
+                fprintf(file,"%d,%d,%s,%s\n", cpu_clock, node->p->pid, STATES[STATE_NEW], STATES[STATE_READY]);
+                
+                node = temp;
+            } else {
+                node = node->next;
+            }
+        } 
+
+        if(running != NULL){
+            // remove the time step from remaining time until process completetion, next io event and end of quantum
+            running->p->cpu_time_remaining --;
+            running->p->io_time_remaining --;
+            temp_quantum--;
+            ran++;
+            share = &shares[running->p->slot];
+            share->received++;
+
+            if(running->p->cpu_time_remaining == 0 || running->p->io_time_remaining == 0){
+                // The process leaves the active set, settle what it was entitled to while it was in it
+                share->entitled += share->tickets * (share_clock - share->active_since);
+                active_tickets -= share->tickets;
+                share->pass += share->stride * ran;
+
+                if(running->p->cpu_time_remaining == 0){
+                    running->p->s = STATE_TERMINATED;
+                    terminated = push_node(terminated,running);
+                    fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_TERMINATED]);
+
+                    running->p->turnaround_time=cpu_clock-running->p->arrival_time;
+                    running->p->wait_time=running->p->turnaround_time-running->p->total_cpu_time;
+                } else {
+                    running->p->io_time_remaining = next_io_burst(running->p);
+                    running->p->s = STATE_WAITING;
+                    waiting_list = push_node(waiting_list,running);
+                    fprintf(file,"%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_WAITING]);
+                }
+                running = NULL;
+            }
+            else if(temp_quantum == 0){
+                // The quantum has expired, back to the ready queue to compete again
+                running->p->s = STATE_READY;
+                share->pass += share->stride * ran;
+                if(lottery) fenwick_add(tree, count, running->p->slot, share->tickets);
+                else heap_push(&ready_heap, running, share->pass);
+                ready_count++;
+                fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_READY]);
+                running = NULL;
+            }
+        }
+
+        // Make sure the CPU is running a process, chosen by lottery draw or lowest pass
+        if(running == NULL && ready_count > 0){
+            if(lottery){
+                i = fenwick_find(tree, count, (long long) (random_next(&state) % (unsigned long long) (active_tickets)));
+                fenwick_add(tree, count, i, -shares[i].tickets);
+                running = shares[i].node;
+            } else {
+                running = heap_pop(&ready_heap);
+                global_pass = shares[running->p->slot].pass;
+            }
+            ready_count--;
+            running->p->s = STATE_RUNNING;
+            temp_quantum = time_quantum;
+            ran = 0;
+            fprintf(file, "%d,%d,%s,%s\n", cpu_clock, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING]);
+        }
+
+        // The simulation is completed when all the queues are empty, in otherwords, all programs have run to completion
+        simulation_completed = (ready_count == 0) && (new_list == NULL) && (waiting_list == NULL) && (running == NULL);
+    }
+
+    // Close the output file
+    fclose(file);
+
+    // Output average time
+    node = terminated;
+    while(node!= NULL) {
+        avg_wt +=node->p->wait_time;
+        avg_tt +=node->p->turnaround_time;
+        proc_count++;
+        node=node->next;
+    } 
+    printf("Average waiting time: %2.f, Average turnaround time: %2.f\n", (avg_wt*1.0)/proc_count, (avg_tt*1.0)/proc_count);
+
+    // Achieved against configured share
+    long long total_tickets = 0;
+    for(i=0; i<count; i++) total_tickets += shares[i].tickets;
+    printf("PID, Tickets, Configured Share, Entitled CPU, Received CPU, Achieved/Entitled\n");
+    for(i=0; i<count; i++){
+        share = &shares[i];
+        printf("%d, %d, %.3f, %.1f, %d, %.2f\n", share->node->p->pid, share->tickets, (share->tickets*1.0)/total_tickets,
+            share->entitled, share->received, share->entitled > 0 ? share->received/share->entitled : 0.0);
+    }
+    printf("\n");
+
+    // The simulation is done, all the nodes are in the terminated list, free them
+    free(shares);
+    free(tree);
+    free(ready_heap.entries);
+    clean_up(terminated);
+}
+
+// The longest horizon simulated by default for periodic tasks, the hyperperiod is cut off here
+#define MAX_HORIZON 1000000
+
+/* FUNCTION DESCRIPTION: job_deadline
+* The absolute deadline of job k of a task, LLONG_MAX for a task without a deadline
+*/
+long long job_deadline(proc_t p, int k){
+    if(p->deadline <= 0) return LLONG_MAX;
+    return p->arrival_time + (long long) k*p->period + p->deadline;
+}
+
+/* FUNCTION DESCRIPTION: realtime_key
+* The ready heap key of a task: the deadline of its current job for EDF, its period for Rate Monotonic.
+* Tasks without a deadline (EDF) or period (RM) only run when nothing else is ready
+*/
+long long realtime_key(proc_t p, bool edf){
+    if(edf) return job_deadline(p, p->current_job);
+    return p->period > 0 ? p->period : LLONG_MAX;
+}
+
+/* FUNCTION DESCRIPTION: gcd
+*/
+static long long gcd(long long a, long long b){
+    while(b != 0){
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* FUNCTION DESCRIPTION: schedulability
+* Prints the schedulability analysis of the periodic tasks in list:
+*    -EDF: the total density (C/min(D,T)) must be at most 1, exact when every deadline equals its period
+*    -RM: the Liu and Layland utilization bound n(2^(1/n)-1), and when it is exceeded the exact
+*     response time analysis R = C + sum over shorter periods of ceil(R/T)*C, which must stay within D
+*/
+void schedulability(node_t list, bool edf){
+    node_t node, other;
+    double utilization = 0, density = 0, bound;
+    long long response, previous, interference;
+    int n = 0;
+    bool feasible = true;
+
+    for(node = list; node != NULL; node = node->next){
+        proc_t p = node->p;
+        if(p->period <= 0) continue;
+        n++;
+        utilization += (double) p->total_cpu_time / p->period;
+        density += (double) p->total_cpu_time / (p->deadline < p->period ? p->deadline : p->period);
+    }
+    if(n == 0){
+        printf("Schedulability: no periodic tasks\n");
+        return;
+    }
+
+    if(edf){
+        printf("Schedulability (EDF): utilization %.3f, density %.3f, %s\n", utilization, density,
+            density <= 1.0 ? "schedulable" : (utilization > 1.0 ? "not schedulable" : "not guaranteed (density above 1)"));
+        return;
+    }
+
+    bound = n*(pow(2.0, 1.0/n) - 1);
+    printf("Schedulability (RM): utilization %.3f, Liu and Layland bound %.3f for %d tasks, %s\n", utilization, bound, n,
+        utilization <= bound ? "schedulable" : "checking response times");
+    if(utilization <= bound) return;
+
+    printf("PID, C, T, D, Worst Case Response Time\n");
+    for(node = list; node != NULL; node = node->next){
+        proc_t p = node->p;
+        if(p->period <= 0) continue;
+
+        // Iterate to the fixed point, or until the response time is past the deadline
+        response = p->total_cpu_time;
+        do {
+            previous = response;
+            interference = 0;
+            for(other = list; other != NULL; other = other->next){
+                proc_t q = other->p;
+                if(q == p || q->period <= 0 || q->period > p->period || (q->period == p->period && q->pid > p->pid)) continue;
+                interference += ((previous + q->period - 1) / q->period) * q->total_cpu_time;
+            }
+            response = p->total_cpu_time + interference;
+        } while(response != previous && response <= p->deadline);
+
+        if(response > p->deadline) feasible = false;
+        printf("%d, %d, %d, %d, %s%lld\n", p->pid, p->total_cpu_time, p->period, p->deadline, response > p->deadline ? ">" : "", response > p->deadline ? (long long) p->deadline : response);
+    }
+    printf("Response time analysis: %s\n", feasible ? "schedulable" : "not schedulable");
+}
+
+/* FUNCTION DESCRIPTION: realtime
+* Earliest Deadline First or Rate Monotonic preemptive real time algorith implimentation.
+* Every process is a task with Total CPU Time per job. A task with a Period releases a job at its arrival
+* and every period after it before the horizon (the hyperperiod after the last arrival by default), a task
+* without one releases a single job. The relative deadline is the Deadline column, or the period if there
+* is none. io is not simulated for real time tasks.
+* The simulation is event driven: the clock jumps to the next job release, kept in a heap of release timers,
+* or the completion of the running job, and the ready tasks are kept in a heap ordered by deadline or period.
+* Every finished job's lateness is recorded, the number of deadline misses and the distribution of their
+* lateness are reported along with the schedulability analysis of the task set.
+* The averages are per job: turnaround is the response time from release to completion and waiting is the
+* part of it the job spent ready, so the idle time of a task between its jobs is not counted.
+*/
+void realtime(char *input_file, char *output_file, bool edf, long long horizon) 
+{
+	int jobs=0, missed=0, finished_jobs=0, i;
+	node_t new_list = NULL, node;
+    node_t running = NULL;
+    struct ready_heap ready_heap = { NULL, 0, 0, 0 }, releases = { NULL, 0, 0, 0 };
+    long long now = 0, next, finish, lateness, total_lateness = 0, min_lateness = LLONG_MAX, max_lateness = LLONG_MIN;
+    long long hyperperiod = 1, last_arrival = 0, histogram[HISTOGRAM_BUCKETS] = {0};
+    long long response, total_response = 0, total_wait = 0, min_response = LLONG_MAX, max_response = 0;
+    proc_t p;
+
+    // Process meta data should be read from a text file
+    printf("%s Scheduler for %s\n", edf ? "EDF" : "RM", input_file);
+    new_list = read_proc_from_file(input_file);
+
+    for(node = new_list; node != NULL; node = node->next){
+        p = node->p;
+        if(p->period > 0 && p->deadline <= 0) p->deadline = p->period;
+        if(p->period > 0 && hyperperiod <= MAX_HORIZON) hyperperiod = hyperperiod / gcd(hyperperiod, p->period) * p->period;
+        if(p->arrival_time > last_arrival) last_arrival = p->arrival_time;
+    }
+    if(horizon <= 0) horizon = last_arrival + (hyperperiod < MAX_HORIZON ? hyperperiod : MAX_HORIZON);
+
+	//open output file and write heading to file
+	FILE *file = fopen(output_file, "w");
+    fprintf(file,"%s, %s, %s, %s\n","Time of transition","PID","Old State","New State");
+
+    // Every task starts with a release timer at its arrival
+    for(node = new_list; node != NULL; node = node->next) heap_push(&releases, node, node->p->arrival_time);
+
+    while(releases.count > 0 || ready_heap.count > 0 || running != NULL){
+        // Jump to the next event
+        next = releases.count > 0 ? releases.entries[0].key : LLONG_MAX;
+        finish = running != NULL ? now + running->p->cpu_time_remaining : LLONG_MAX;
+        if(finish < next) next = finish;
+        if(running != NULL) running->p->cpu_time_remaining -= next - now;
+        now = next;
+
+        if(running != NULL && running->p->cpu_time_remaining == 0){
+            // The job is done, record its response time and how late it was
+            node = running;
+            p = node->p;
+            response = now - (p->arrival_time + (long long) p->current_job*p->period);
+            finished_jobs++;
+            total_response += response;
+            total_wait += response - p->total_cpu_time;
+            if(response < min_response) min_response = response;
+            if(response > max_response) max_response = response;
+            lateness = now - job_deadline(p, p->current_job);
+            if(p->deadline > 0){
+                jobs++;
+                total_lateness += lateness;
+                if(lateness < min_lateness) min_lateness = lateness;
+                if(lateness > max_lateness) max_lateness = lateness;
+                if(lateness > 0){
+                    missed++;
+                    histogram[histogram_bucket(lateness > INT_MAX ? INT_MAX : (int) lateness)]++;
+                }
+            }
+            p->current_job++;
+            running = NULL;
+
+            if(p->current_job < p->released_jobs){
+                // The next job was released while this one ran, it is ready straight away
+                p->cpu_time_remaining = p->total_cpu_time;
+                p->s = STATE_READY;
+                heap_push(&ready_heap, node, realtime_key(p, edf));
+                fprintf(file, "%lld,%d,%s,%s\n", now, p->pid, STATES[STATE_RUNNING], STATES[STATE_READY]);
+            } else if(p->period > 0 && p->arrival_time + (long long) p->released_jobs*p->period < horizon){
+                // Wait for the next release
+                p->s = STATE_WAITING;
+                fprintf(file, "%lld,%d,%s,%s\n", now, p->pid, STATES[STATE_RUNNING], STATES[STATE_WAITING]);
+            } else {
+                p->s = STATE_TERMINATED;
+                p->turnaround_time = now - p->arrival_time;
+                fprintf(file, "%lld,%d,%s,%s\n", now, p->pid, STATES[STATE_RUNNING], STATES[STATE_TERMINATED]);
+            }
+        }
+
+        // Release every job due now and set the timer for the next one
+        while(releases.count > 0 && releases.entries[0].key == now){
+            node = heap_pop(&releases);
+            p = node->p;
+            p->released_jobs++;
+            if(p->period > 0 && p->arrival_time + (long long) p->released_jobs*p->period < horizon){
+                heap_push(&releases, node, p->arrival_time + (long long) p->released_jobs*p->period);
+            }
+
+            // A task still busy with an earlier job picks this one up when that one is done
+            if(p->current_job == p->released_jobs-1){
+                p->cpu_time_remaining = p->total_cpu_time;
+                fprintf(file, "%lld,%d,%s,%s\n", now, p->pid, STATES[p->s], STATES[STATE_READY]);
+                p->s = STATE_READY;
+                heap_push(&ready_heap, node, realtime_key(p, edf));
+            }
+        }
+
+        // Run the most urgent ready task, preempting the running one if it is less urgent
+        if(running != NULL && ready_heap.count > 0 && ready_heap.entries[0].key < realtime_key(running->p, edf)){
+            running->p->s = STATE_READY;
+            heap_push(&ready_heap, running, realtime_key(running->p, edf));
+            fprintf(file, "%lld,%d,%s,%s\n", now, running->p->pid, STATES[STATE_RUNNING], STATES[STATE_READY]);
+            running = NULL;
+        }
+        if(running == NULL && ready_heap.count > 0){
+            running = heap_pop(&ready_heap);
+            running->p->s = STATE_RUNNING;
+            fprintf(file, "%lld,%d,%s,%s\n", now, running->p->pid, STATES[STATE_READY], STATES[STATE_RUNNING]);
+        }
+    }
+
+    // Close the output file
+    fclose(file);
+
+    // Output average time per job
+    printf("Average waiting time: %2.f, Average turnaround time: %2.f\n", (total_wait*1.0)/finished_jobs, (total_response*1.0)/finished_jobs);
+    if(finished_jobs > 0) printf("Jobs: %d, response time: min %lld, mean %.1f, max %lld\n", finished_jobs, min_response, (double) total_response/finished_jobs, max_response);
+
+    printf("Horizon: %lldms, jobs with a deadline: %d, deadline misses: %d (%.1f%%)\n", horizon, jobs, missed, jobs ? 100.0*missed/jobs : 0.0);
+    if(jobs > 0) printf("Lateness: min %lld, mean %.1f, max %lld\n", min_lateness, (double) total_lateness/jobs, max_lateness);
+    if(missed > 0){
+        printf("Lateness From, Lateness To, Missed Jobs\n");
+        for(i=1; i<HISTOGRAM_BUCKETS; i++){
+            if(histogram[i] > 0) printf("%lld, %lld, %lld\n", 1LL<<(i-1), (1LL<<i)-1, histogram[i]);
+        }
+    }
+    schedulability(new_list, edf);
+    printf("\n");
+
+    // The simulation is done, the processes are all still in new_list
+    free(ready_heap.entries);
+    free(releases.entries);
+    clean_up(new_list);
+}
+
+// z value of the 95% confidence intervals of the Monte Carlo mode, the normal approximation
+#define CONFIDENCE_Z 1.96
+
+/* FUNCTION DESCRIPTION: counter_random
+* Counter based generator: the value only depends on the seed, the stream and the counter, so a replica
+* draws the same numbers whichever thread runs it and in whatever order
+*/
+unsigned long long counter_random(unsigned long long seed, unsigned long long stream, unsigned long long counter){
+    unsigned long long state = (seed ^ (stream * 0xD1B54A32D192ED03ULL)) + counter * 0xA0761D6478BD642FULL;
+    return random_next(&state);
+}
+
+/* FUNCTION DESCRIPTION: jitter
+* Scales value by a factor drawn uniformly from [1 - percent%, 1 + percent%] and rounds it
+*/
+static int jitter(int value, int percent, unsigned long long seed, unsigned long long stream, unsigned long long counter){
+    double factor = 1.0 + percent/100.0 * (2.0 * (counter_random(seed, stream, counter) >> 11) / 9007199254740992.0 - 1.0);
+    return (int) floor(value * factor + 0.5);
+}
+
+// The averages of one Monte Carlo replica
+struct replica
+{
+    double wait, turnaround, utilization;
+    int finished, unfinished;
+};
+
+// The work handed to one Monte Carlo thread: replicas thread, thread+threads, ...
+struct monte_carlo_job
+{
+    node_t workload;
+    struct replica *replicas;
+    int count;
+    int thread, threads;
+    enum POLICY policy;
+    struct sim_config *config;
+    int percent;
+    unsigned long long seed;
+};
+
+/* FUNCTION DESCRIPTION: run_replicas
+* Thread body, perturbs a copy of the workload for each replica assigned to this thread and runs it through
+* the policy's kernel with logging off. Each process draws its jitter from stream replica, counter
+* 4*index+field of the counter based generator. Burst lists are not perturbed.
+*/
+void *run_replicas(void *arg){
+    struct monte_carlo_job *job = (struct monte_carlo_job *) arg;
+    Partition memory_partition[4];
+    struct sim_config config = *job->config;
+    node_t copy, node;
+    proc_t p;
+    int processes = 0, index, finished;
+    long long wait, turnaround, busy, end;
+
+    for(node = job->workload; node != NULL; node = node->next) processes++;
+    config.memory_partition = memory_partition;
+
+    for(int r = job->thread; r < job->count; r += job->threads){
+        copy = copy_list(job->workload);
+        for(index = 0, node = copy; index < processes; index++, node = node->next){
+            p = node->p;
+            p->total_cpu_time = jitter(p->total_cpu_time, job->percent, job->seed, r, 4*index);
+            if(p->total_cpu_time < 1) p->total_cpu_time = 1;
+            p->cpu_time_remaining = p->total_cpu_time;
+            p->arrival_time = jitter(p->arrival_time, job->percent, job->seed, r, 4*index+1);
+            if(p->arrival_time < 0) p->arrival_time = 0;
+            if(p->io_frequency > 0 && p->burst_count == 0){
+                p->io_frequency = jitter(p->io_frequency, job->percent, job->seed, r, 4*index+2);
+                if(p->io_frequency < 1) p->io_frequency = 1;
+                p->io_time_remaining = p->io_frequency;
+            }
+            if(p->io_duration > 0){
+                p->io_duration = jitter(p->io_duration, job->percent, job->seed, r, 4*index+3);
+                if(p->io_duration < 1) p->io_duration = 1;
+            }
+        }
+
+        memcpy(memory_partition, job->config->memory_partition, sizeof(memory_partition));
+        select_kernel(job->policy, copy, false, MODE_PLAIN)(copy, NULL, &config);
+
+        // The processes of the copy are one block, whatever lists the kernel left them in
+        wait = turnaround = busy = end = 0;
+        finished = 0;
+        for(index = 0; index < processes; index++){
+            p = &copy->p[index];
+            if(p->s != STATE_TERMINATED) continue;
+            finished++;
+            wait += p->wait_time;
+            turnaround += p->turnaround_time;
+            busy += p->total_cpu_time;
+            if(p->arrival_time + p->turnaround_time > end) end = p->arrival_time + p->turnaround_time;
+        }
+        job->replicas[r].finished = finished;
+        job->replicas[r].unfinished = processes - finished;
+        job->replicas[r].wait = finished ? (double) wait/finished : 0;
+        job->replicas[r].turnaround = finished ? (double) turnaround/finished : 0;
+        job->replicas[r].utilization = end > 0 ? (double) busy/end : 0;
+        free_copy(copy);
+    }
+    return NULL;
+}
+
+/* FUNCTION DESCRIPTION: print_interval
+* Prints the mean and 95% confidence interval of one measure over n replicas
+*/
+static void print_interval(char *name, double sum, double sum_squares, int n){
+    double mean = sum/n;
+    double variance = n > 1 ? (sum_squares - n*mean*mean)/(n-1) : 0;
+    double half = CONFIDENCE_Z * sqrt(variance > 0 ? variance : 0) / sqrt(n);
+    printf("%s: mean %.2f, 95%% CI [%.2f, %.2f]\n", name, mean, mean - half, mean + half);
+}
+
+/* FUNCTION DESCRIPTION: monte_carlo
+* Runs replicas perturbed copies of the workload through the policy's specialized kernel, spread over one
+* thread per core. In each replica the Total CPU Time, Arrival Time, I/O Frequency and I/O Duration of every
+* process are scaled by a random factor within percent% of 1. The averages of every replica are written to
+* output_file and their mean and confidence interval printed. Utilization is CPU busy time over the time
+* the last process finished, for mm it can be above 1 as the partitions run at the same time.
+* Replicas are simulated for at most a bound no correct schedule can exceed. Processes that never terminate
+* (possible after a priority() preemption) are left out of the averages and counted separately.
+*/
+void monte_carlo(char *input_file, char *output_file, enum POLICY policy, struct sim_config *config, int replicas, int percent, unsigned long long seed) 
+{
+    node_t workload, node;
+    struct replica *results;
+    struct monte_carlo_job *jobs;
+    double sums[3] = {0}, squares[3] = {0};
+    long long bound = 0;
+    int threads, measured = 0, unfinished = 0, i;
+
+    if(replicas < 1) replicas = 1;
+    if(percent < 0 || percent >= 100){
+        printf("Error! The jitter must be at least 0 and below 100 percent\n");
+        exit(1);
+    }
+
+    // Process meta data should be read from a text file
+    printf("Monte Carlo %s simulation for %s: %d replicas, %d%% jitter, seed %llu\n", POLICIES[policy], input_file, replicas, percent, seed);
+    workload = read_proc_from_file(input_file);
+
+    // Even if it ran alone after the last arrival, every process is done by its CPU time plus the time of every io call
+    for(node = workload; node != NULL; node = node->next){
+        proc_t p = node->p;
+        int bursts = p->io_frequency > 0 ? p->total_cpu_time / p->io_frequency + 1 : 1;
+        bound += (long long) (p->total_cpu_time + (p->io_duration > 0 ? bursts*p->io_duration : 0)) * (100 + percent) / 100 + 1;
+        for(i = 0; i < p->burst_count; i++) bound += burst_arena.bursts[p->burst_offset + i];
+        if(p->arrival_time * (100 + percent) / 100 > bound) bound += p->arrival_time * (100 + percent) / 100;
+    }
+    clock_limit = bound*2 + 1000 < INT_MAX ? (int) (bound*2 + 1000) : INT_MAX;
+
+    threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads > replicas) threads = replicas;
+    if(threads < 1) threads = 1;
+
+    results = (struct replica *) calloc(replicas, sizeof(struct replica));
+    pthread_t *thread_ids = (pthread_t *) malloc(threads*sizeof(pthread_t));
+    jobs = (struct monte_carlo_job *) malloc(threads*sizeof(struct monte_carlo_job));
+    for(i=0; i<threads; i++){
+        jobs[i].workload = workload;
+        jobs[i].replicas = results;
+        jobs[i].count = replicas;
+        jobs[i].thread = i;
+        jobs[i].threads = threads;
+        jobs[i].policy = policy;
+        jobs[i].config = config;
+        jobs[i].percent = percent;
+        jobs[i].seed = seed;
+        pthread_create(&thread_ids[i], NULL, run_replicas, &jobs[i]);
+    }
+    for(i=0; i<threads; i++) pthread_join(thread_ids[i], NULL);
+    clock_limit = INT_MAX;
+
+    // Aggregate in replica order so the sums do not depend on the threads
+    FILE *file = fopen(output_file, "w");
+    fprintf(file, "%s, %s, %s, %s, %s\n", "Replica", "Average Waiting Time", "Average Turnaround Time", "Utilization", "Unfinished Processes");
+    for(i=0; i<replicas; i++){
+        fprintf(file, "%d,%.3f,%.3f,%.4f,%d\n", i, results[i].wait, results[i].turnaround, results[i].utilization, results[i].unfinished);
+        unfinished += results[i].unfinished;
+        if(results[i].finished == 0) continue;
+        measured++;
+        sums[0] += results[i].wait;
+        squares[0] += results[i].wait*results[i].wait;
+        sums[1] += results[i].turnaround;
+        squares[1] += results[i].turnaround*results[i].turnaround;
+        sums[2] += results[i].utilization;
+        squares[2] += results[i].utilization*results[i].utilization;
+    }
+    fclose(file);
+
+    printf("%d replicas on %d threads, %d processes left unfinished over all replicas\n", replicas, threads, unfinished);
+    if(measured > 0){
+        print_interval("Average waiting time", sums[0], squares[0], measured);
+        print_interval("Average turnaround time", sums[1], squares[1], measured);
+        print_interval("Utilization", sums[2], squares[2], measured);
+    }
+    printf("\n");
+
+    free(results);
+    free(thread_ids);
+    free(jobs);
+    clean_up(workload);
+}
+
+// The power model used when no file is given: three P-states and a polling, a light and a deep sleep C-state
+static const struct power_model DEFAULT_POWER_MODEL = {
+    3, { 100, 75, 50 }, { 10.0, 6.0, 3.5 }, { 1, 1, 1 },
+    3, { 2.5, 1.0, 0.1 }, { 0, 1, 5 }, { 0, 2, 20 },
+    0
+};
+
+/* FUNCTION DESCRIPTION: load_power_model
+* Reads a power model from a CSV file with a header row and one row per power state:
+*    State,Speed,Power,Latency,Residency
+*    P0,100,10.0,1,0
+*    C1,0,1.0,1,2
+* Rows whose state starts with P are P-states, listed fastest first, with the percent of full speed,
+* the active power in watts and the transition latency in milliseconds.
+* Rows whose state starts with C are C-states, listed shallowest first, with the idle power in watts,
+* the exit latency and the target residency in milliseconds. The first C-state has a residency of 0.
+* A file name of "-" loads the default model.
+*/
+void load_power_model(char *power_file, struct power_model *model)
+{
+    char row[256], name[16];
+    int speed, latency, residency;
+    double power;
+
+    if(strcmp(power_file, "-") == 0){
+        *model = DEFAULT_POWER_MODEL;
+        return;
+    }
+
+    FILE *f = fopen(power_file, "r");
+    if(f == NULL){
+        printf("Error! Could not open power model %s\n", power_file);
+        exit(1);
+    }
+    memset(model, 0, sizeof(struct power_model));
+
+    // Skip the header row
+    fgets(row, sizeof(row), f);
+    while(fgets(row, sizeof(row), f) != NULL) {
+        if(sscanf(row, " %15[^,],%d,%lf,%d,%d", name, &speed, &power, &latency, &residency) != 5) continue;
+
+        if(name[0] == 'P' && model->p_states < MAX_POWER_STATES){
+            if(speed < 1 || speed > 100 || (model->p_states > 0 && speed > model->speed[model->p_states-1])){
+                printf("Error! P-state %s must be 1 to 100 percent and no faster than the one before\n", name);
+                exit(1);
+            }
+            model->speed[model->p_states] = speed;
+            model->active_power[model->p_states] = power;
+            model->transition_latency[model->p_states] = latency;
+            model->p_states++;
+        }
+        else if(name[0] == 'C' && model->c_states < MAX_POWER_STATES){
+            if(model->c_states > 0 && residency < model->target_residency[model->c_states-1]){
+                printf("Error! C-state %s must not have a shorter residency than the one before\n", name);
+                exit(1);
+            }
+            model->idle_power[model->c_states] = power;
+            model->exit_latency[model->c_states] = latency;
+            model->target_residency[model->c_states] = model->c_states == 0 ? 0 : residency;
+            model->c_states++;
+        }
+    }
+    fclose(f);
+
+    if(model->p_states == 0 || model->c_states == 0){
+        printf("Error! The power model %s needs at least one P-state and one C-state\n", power_file);
+        exit(1);
+    }
+}
+
+/* FUNCTION DESCRIPTION: energy
+* Runs fcfs, priority or rr on the specialized kernel with the power model in power_file and reports
+* the energy it used next to the average times. governor is the P-state the CPU runs in, P0 races to idle and
+* the slower P-states spread the work out, or GOVERNOR_ONDEMAND. Unlike rr() the quantum is enforced so
+* rr really spreads the CPU over the ready processes.
+*/
+void energy(char *input_file, char *output_file, enum POLICY policy, struct sim_config *config, char *power_file, int governor)
+{
+    struct power_model model;
+    struct energy_stats stats;
+
+    load_power_model(power_file, &model);
+    if(governor != GOVERNOR_ONDEMAND && (governor < 0 || governor >= model.p_states)){
+        printf("Error! The governor must be a P-state from 0 to %d or %d for ondemand\n", model.p_states-1, GOVERNOR_ONDEMAND);
+        exit(1);
+    }
+    if(policy == POLICY_RR && config->time_quantum < 1){
+        printf("Error! The time quantum must be at least 1\n");
+        exit(1);
+    }
+    model.governor = governor;
+    memset(&stats, 0, sizeof(struct energy_stats));
+
+    if(governor == GOVERNOR_ONDEMAND) printf("Power model %s, ondemand governor\n", power_file);
+    else printf("Power model %s, running at P%d (%d%%)\n", power_file, governor, model.speed[governor]);
+
+    config->power = &model;
+    config->energy = &stats;
+    specialized(input_file, output_file, policy, config);
+    config->power = NULL;
+    config->energy = NULL;
+}
+
+/* FUNCTION DESCRIPTION: dispatch_overhead
+* Runs fcfs, priority or rr on the specialized kernel that charges switch_cost milliseconds for every dispatch
+* plus a cache warm-up of up to warmup milliseconds, reached after an absence of decay milliseconds,
+* and reports the time lost to it and the throughput next to the average times.
+* Unlike rr() the quantum is enforced, as for energy().
+*/
+void dispatch_overhead(char *input_file, char *output_file, enum POLICY policy, struct sim_config *config, int switch_cost, int warmup, int decay)
+{
+    struct switch_model model = { switch_cost, warmup, decay > 0 ? decay : 1 };
+    struct overhead_stats stats = { 0, 0, 0 };
+
+    if(switch_cost < 0 || warmup < 0){
+        printf("Error! The context switch cost and warm-up penalty can not be negative\n");
+        exit(1);
+    }
+    if(policy == POLICY_RR && config->time_quantum < 1){
+        printf("Error! The time quantum must be at least 1\n");
+        exit(1);
+    }
+    printf("Context switch %d ms, warm-up up to %d ms after %d ms away\n", model.switch_cost, model.warmup, model.decay);
+
+    config->switching = &model;
+    config->overhead = &stats;
+    specialized(input_file, output_file, policy, config);
+    config->switching = NULL;
+    config->overhead = NULL;
+}
+
+int main(int argc, char *argv[])
+{
+	if(argc>3) {
+		if(atoi(argv[3])==1) fcfs(argv[1],argv[2]);
+		if(atoi(argv[3])==2) priority(argv[1],argv[2]);
+		if(atoi(argv[3])==3) rr(argv[1],argv[2], atoi(argv[3]));
+		if(atoi(argv[3])==4) {
+			Partition memory_partition[4];
+
+			for(int i=0, j=5; i<4; i++, j++) {
+				memory_partition[i].size=atoi(argv[j]);
+				memory_partition[i].occupied=false;
+			}
+
+			if((memory_partition[0].size+memory_partition[1].size+memory_partition[2].size+memory_partition[3].size)>1000) {
+				printf("Error! total partition size greter than allocated 1Mb");
+				exit(1);
+			}
+
+			mm(argv[1],argv[2], memory_partition);
+		}
+		if(atoi(argv[3])==5) analyze(argv[1],argv[2]);
+		if(atoi(argv[3])==6) ingest_trace(argv[1],argv[2]);
+		if(atoi(argv[3])==7) sjf(argv[1],argv[2], false);
+		if(atoi(argv[3])==8) sjf(argv[1],argv[2], true);
+		if(atoi(argv[3])==9) partitioned(argv[1],argv[2], argc>4 ? atoi(argv[4]) : 0);
+		if(atoi(argv[3])==15) proportional(argv[1],argv[2], argc>4 ? atoi(argv[4]) : 10, true, argc>5 ? strtoull(argv[5], NULL, 10) : 1);
+		if(atoi(argv[3])==16) proportional(argv[1],argv[2], argc>4 ? atoi(argv[4]) : 10, false, 0);
+		if(atoi(argv[3])==17) realtime(argv[1],argv[2], true, argc>4 ? atoll(argv[4]) : 0);
+		if(atoi(argv[3])==18) realtime(argv[1],argv[2], false, argc>4 ? atoll(argv[4]) : 0);
+		if(atoi(argv[3])==19) {
+			Partition memory_partition[4] = { { 500, false, NULL }, { 250, false, NULL }, { 150, false, NULL }, { 100, false, NULL } };
+			struct sim_config config = { argc>8 ? atoi(argv[8]) : 10, memory_partition, NULL, NULL, NULL, NULL };
+			int selection = argc>4 ? atoi(argv[4]) : 1;
+
+			if(selection < 1 || selection > 4) {
+				printf("Error! The Monte Carlo scheduler must be 1 to 4");
+				exit(1);
+			}
+			monte_carlo(argv[1],argv[2], (enum POLICY) (selection-1), &config, argc>5 ? atoi(argv[5]) : 100, argc>6 ? atoi(argv[6]) : 10, argc>7 ? strtoull(argv[7], NULL, 10) : 1);
+		}
+		if(atoi(argv[3])==20) {
+			Partition memory_partition[4];
+			struct sim_config config = { argc>7 ? atoi(argv[7]) : 10, memory_partition, NULL, NULL, NULL, NULL };
+			int selection = argc>4 ? atoi(argv[4]) : 1;
+
+			if(selection < 1 || selection > 3) {
+				printf("Error! The energy model scheduler must be 1 to 3");
+				exit(1);
+			}
+			energy(argv[1],argv[2], (enum POLICY) (selection-1), &config, argc>6 ? argv[6] : "-", argc>5 ? atoi(argv[5]) : 0);
+		}
+		if(atoi(argv[3])==21) {
+			Partition memory_partition[4];
+			struct sim_config config = { argc>8 ? atoi(argv[8]) : 10, memory_partition, NULL, NULL, NULL, NULL };
+			int selection = argc>4 ? atoi(argv[4]) : 1;
+
+			if(selection < 1 || selection > 3) {
+				printf("Error! The dispatch overhead scheduler must be 1 to 3");
+				exit(1);
+			}
+			dispatch_overhead(argv[1],argv[2], (enum POLICY) (selection-1), &config, argc>5 ? atoi(argv[5]) : 1, argc>6 ? atoi(argv[6]) : 5, argc>7 ? atoi(argv[7]) : 50);
+		}
+		if(atoi(argv[3])==10) {
+			Partition memory_partition[4] = { { 500, false, NULL }, { 250, false, NULL }, { 150, false, NULL }, { 100, false, NULL } };
+			struct sim_config config = { 10, memory_partition, NULL, NULL, NULL, NULL };
+			int iterations = 1000;
+			unsigned long long seed = 1;
+
+			if(strcmp(argv[1], "fuzz") == 0) {
+				// The fourth and fifth arguments are the number of workloads and the seed, quanta and partitions are generated
+				if(argc>4) iterations = atoi(argv[4]);
+				if(argc>5) seed = strtoull(argv[5], NULL, 10);
+			} else {
+				if(argc>4) config.time_quantum = atoi(argv[4]);
+				for(int i=0, j=5; i<4 && argc>8; i++, j++) memory_partition[i].size=atoi(argv[j]);
+
+				if((memory_partition[0].size+memory_partition[1].size+memory_partition[2].size+memory_partition[3].size)>1000) {
+					printf("Error! total partition size greter than allocated 1Mb");
+					exit(1);
+				}
+			}
+			verify(argv[1],argv[2], &config, iterations, seed);
+		}
+		if(atoi(argv[3])>=11 && atoi(argv[3])<=14) {
+			Partition memory_partition[4];
+			struct sim_config config = { argc>4 ? atoi(argv[4]) : 0, memory_partition, NULL, NULL, NULL, NULL };
+
+			for(int i=0, j=5; i<4; i++, j++) {
+				memory_partition[i].size = j<argc ? atoi(argv[j]) : 0;
+				memory_partition[i].occupied=false;
+			}
+
+			if((memory_partition[0].size+memory_partition[1].size+memory_partition[2].size+memory_partition[3].size)>1000) {
+				printf("Error! total partition size greter than allocated 1Mb");
+				exit(1);
+			}
+
+			specialized(argv[1],argv[2], (enum POLICY) (atoi(argv[3])-11), &config);
+		}
+	}
+
+	else if(argc==3) {
+		int schedule, time_quantum;
+		Partition memory_partition[4];
+
+		printf("1. First Come First Serve\n");
+		printf("2. Non-preemptive Priority\n");
+		printf("3. Round Robin\n");
+		printf("4. Memory management\n");
+		printf("5. Transition log analysis\n");
+		printf("6. Kernel trace ingestion\n");
+		printf("7. Shortest Job First\n");
+		printf("8. Shortest Remaining Time First\n");
+		printf("9. Partitioned parallel FCFS / Round Robin\n");
+		printf("10. Verify the specialized kernels\n");
+		printf("11-14. Options 1-4 on specialized kernels\n");
+		printf("15. Lottery\n");
+		printf("16. Stride\n");
+		printf("17. Earliest Deadline First\n");
+		printf("18. Rate Monotonic\n");
+		printf("19. Monte Carlo\n");
+		printf("20. Energy and DVFS model\n");
+		printf("21. Context switch and cache warm-up overhead\n");
+		printf("Enter simulation option: ");
+		scanf("%d", &schedule);
+		
+		switch(schedule) {
+		case 1:
+			printf("\nRunning FCFS scheduler for %s\n",argv[1]);
+			printf("-------------------\n");
+			fcfs(argv[1],argv[2]);
+			break;
+
+		case 2:
+			printf("\nRunning Non-preemptive Priority scheduler for %s\n",argv[1]);
+			printf("-------------------\n");
+			priority(argv[1],argv[2]);
+			break;
+
+		case 3:
+			printf("Enter Time quantum: ");
+			scanf("%d", &time_quantum);
+			printf("\nRunning Round Robin scheduler for %s\n",argv[1]);
+			printf("\nTime quantum: %d\n",time_quantum);
+			printf("-------------------\n");
+			rr(argv[1],argv[2], time_quantum);
+			break;
+
+		case 4:
+			printf("\nRunning Memory Management scheduler for %s\n",argv[1]);
+			printf("-------------------\n");
+			for(int i=0; i<4; i++) {
+				printf("Enter the size of partition %d: ",i+1);
+				scanf("%d", &memory_partition[i].size);
+				memory_partition[i].occupied=false;
+			}
+
+			if((memory_partition[0].size+memory_partition[1].size+memory_partition[2].size+memory_partition[3].size)>1000) {
+				printf("Error! total partition size greter than allocated 1Mb");
+				exit(1);
+			}
+
+			mm(argv[1],argv[2], memory_partition);
+			break;
+
+		case 5:
+			printf("\nRunning transition log analysis for %s\n",argv[1]);
+			printf("-------------------\n");
+			analyze(argv[1],argv[2]);
+			break;
+
+		case 6:
+			printf("\nRunning kernel trace ingestion for %s\n",argv[1]);
+			printf("-------------------\n");
+			ingest_trace(argv[1],argv[2]);
+			break;
+
+		case 7:
+			printf("\nRunning Shortest Job First scheduler for %s\n",argv[1]);
+			printf("-------------------\n");
+			sjf(argv[1],argv[2], false);
+			break;
+
+		case 8:
+			printf("\nRunning Shortest Remaining Time First scheduler for %s\n",argv[1]);
+			printf("-------------------\n");
+			sjf(argv[1],argv[2], true);
+			break;
+
+		case 9:
+			printf("Enter Time quantum (0 for FCFS): ");
+			scanf("%d", &time_quantum);
+			printf("\nRunning partitioned scheduler for %s\n",argv[1]);
+			printf("-------------------\n");
+			partitioned(argv[1],argv[2], time_quantum);
+			break;
+
+		case 10: {
+			Partition verify_partition[4] = { { 500, false, NULL }, { 250, false, NULL }, { 150, false, NULL }, { 100, false, NULL } };
+			struct sim_config config = { 10, verify_partition, NULL, NULL, NULL, NULL };
+
+			printf("\nVerifying the specialized kernels on %s\n",argv[1]);
+			printf("-------------------\n");
+			verify(argv[1],argv[2], &config, 1000, 1);
+			break;
+		}
+
+		case 11:
+		case 12:
+		case 13:
+		case 14: {
+			struct sim_config config = { 0, memory_partition, NULL, NULL, NULL, NULL };
+
+			if(schedule == 13) {
+				printf("Enter Time quantum: ");
+				scanf("%d", &config.time_quantum);
+			}
+			for(int i=0; i<4; i++) {
+				memory_partition[i].size=0;
+				memory_partition[i].occupied=false;
+				if(schedule != 14) continue;
+				printf("Enter the size of partition %d: ",i+1);
+				scanf("%d", &memory_partition[i].size);
+			}
+
+			if((memory_partition[0].size+memory_partition[1].size+memory_partition[2].size+memory_partition[3].size)>1000) {
+				printf("Error! total partition size greter than allocated 1Mb");
+				exit(1);
+			}
+
+			printf("\nRunning %s scheduler on a specialized kernel for %s\n", POLICIES[schedule-11], argv[1]);
+			printf("-------------------\n");
+			specialized(argv[1],argv[2], (enum POLICY) (schedule-11), &config);
+			break;
+		}
+
+		case 15:
+		case 16:
+			printf("Enter Time quantum: ");
+			scanf("%d", &time_quantum);
+			printf("\nRunning %s scheduler for %s\n", schedule == 15 ? "Lottery" : "Stride", argv[1]);
+			printf("\nTime quantum: %d\n",time_quantum);
+			printf("-------------------\n");
+			proportional(argv[1],argv[2], time_quantum, schedule == 15, 1);
+			break;
+
+		case 17:
+		case 18:
+			printf("\nRunning %s scheduler for %s\n", schedule == 17 ? "Earliest Deadline First" : "Rate Monotonic", argv[1]);
+			printf("-------------------\n");
+			realtime(argv[1],argv[2], schedule == 17, 0);
+			break;
+
+		case 19: {
+			Partition monte_carlo_partition[4] = { { 500, false, NULL }, { 250, false, NULL }, { 150, false, NULL }, { 100, false, NULL } };
+			struct sim_config config = { 10, monte_carlo_partition, NULL, NULL, NULL, NULL };
+			int selection, replicas, percent;
+
+			printf("Enter the scheduler (1-4): ");
+			scanf("%d", &selection);
+			if(selection < 1 || selection > 4) {
+				printf("\nError! Invalid selection");
+				exit(1);
+			}
+			if(selection == 3) {
+				printf("Enter Time quantum: ");
+				scanf("%d", &config.time_quantum);
+			}
+			printf("Enter the number of replicas: ");
+			scanf("%d", &replicas);
+			printf("Enter the jitter in percent: ");
+			scanf("%d", &percent);
+			printf("\nRunning Monte Carlo simulation for %s\n",argv[1]);
+			printf("-------------------\n");
+			monte_carlo(argv[1],argv[2], (enum POLICY) (selection-1), &config, replicas, percent, 1);
+			break;
+		}
+
+		case 20: {
+			struct sim_config config = { 10, memory_partition, NULL, NULL, NULL, NULL };
+			char power_file[256];
+			int selection, governor;
+
+			printf("Enter the scheduler (1-3): ");
+			scanf("%d", &selection);
+			if(selection < 1 || selection > 3) {
+				printf("\nError! Invalid selection");
+				exit(1);
+			}
+			if(selection == 3) {
+				printf("Enter Time quantum: ");
+				scanf("%d", &config.time_quantum);
+			}
+			printf("Enter the P-state to run in (-1 for ondemand): ");
+			scanf("%d", &governor);
+			printf("Enter the power model file (- for the default): ");
+			scanf("%255s", power_file);
+			printf("\nRunning %s scheduler with the energy model for %s\n", POLICIES[selection-1], argv[1]);
+			printf("-------------------\n");
+			energy(argv[1],argv[2], (enum POLICY) (selection-1), &config, power_file, governor);
+			break;
+		}
+
+		case 21: {
+			struct sim_config config = { 10, memory_partition, NULL, NULL, NULL, NULL };
+			int selection, switch_cost, warmup, decay;
+
+			printf("Enter the scheduler (1-3): ");
+			scanf("%d", &selection);
+			if(selection < 1 || selection > 3) {
+				printf("\nError! Invalid selection");
+				exit(1);
+			}
+			if(selection == 3) {
+				printf("Enter Time quantum: ");
+				scanf("%d", &config.time_quantum);
+			}
+			printf("Enter the context switch cost: ");
+			scanf("%d", &switch_cost);
+			printf("Enter the maximum cache warm-up penalty: ");
+			scanf("%d", &warmup);
+			printf("Enter the time away until the cache is cold: ");
+			scanf("%d", &decay);
+			printf("\nRunning %s scheduler with dispatch overhead for %s\n", POLICIES[selection-1], argv[1]);
+			printf("-------------------\n");
+			dispatch_overhead(argv[1],argv[2], (enum POLICY) (selection-1), &config, switch_cost, warmup, decay);
+			break;
+		}
 
 		default:
 			printf("\nError! Invalid selection");
@@ -1,4 +1,4 @@
-gcc -o main.exe main.c 
+gcc -O2 -pthread -o main.exe main.c -lm 
 
 echo ""> average_time.txt
 
@@ -23,10 +23,86 @@ do
     ./main.exe test_case_$i.csv rr_test_$i.csv 3 10 >> average_time.txt
 done
 
+# SJF and SRTF test case
+for i in {1..10} 
+do
+    echo "running shortest job first test $i"
+    ./main.exe test_case_$i.csv sjf_test_$i.csv 7 >> average_time.txt
+    ./main.exe test_case_$i.csv srtf_test_$i.csv 8 >> average_time.txt
+done
+
+# Lottery and Stride test case
+for i in {1..10} 
+do
+    echo "running proportional share test $i"
+    ./main.exe test_case_$i.csv lottery_test_$i.csv 15 10 1 >> average_time.txt
+    ./main.exe test_case_$i.csv stride_test_$i.csv 16 10 >> average_time.txt
+done
+
+# EDF and RM test case
+echo "running real time test"
+./main.exe test_case_realtime.csv edf_test.csv 17 >> average_time.txt
+./main.exe test_case_realtime.csv rm_test.csv 18 >> average_time.txt
+
+# Partitioned test case, tenants named by number and by name
+echo "running partitioned test"
+./main.exe test_case_tenants.csv tenants_fcfs_test.csv 9 >> average_time.txt
+./main.exe test_case_tenants.csv tenants_rr_test.csv 9 10 >> average_time.txt
+
+# Kernel trace ingestion test case, the converted workload is run through FCFS
+echo "running trace ingestion test"
+./main.exe test_case_trace.txt trace_workload_test.csv 6 >> average_time.txt
+./main.exe trace_workload_test.csv trace_fcfs_test.csv 1 >> average_time.txt
+
+# Monte Carlo test case
+echo "running monte carlo test"
+./main.exe test_case_4.csv monte_carlo_test.csv 19 3 100 10 1 10 >> average_time.txt
+
+# Energy model test case, racing to idle against spreading the work out
+for i in {1..10} 
+do
+    echo "running energy model test $i"
+    ./main.exe test_case_$i.csv fcfs_energy_test_$i.csv 20 1 0 >> average_time.txt
+    ./main.exe test_case_$i.csv rr_energy_test_$i.csv 20 3 2 - 10 >> average_time.txt
+    ./main.exe test_case_$i.csv rr_ondemand_energy_test_$i.csv 20 3 -1 - 10 >> average_time.txt
+    ./main.exe test_case_$i.csv priority_energy_test_$i.csv 20 2 0 >> average_time.txt
+    # A preempted process goes back to the ready list, so every process must still terminate
+    if [ $(grep -c TERMINATED priority_energy_test_$i.csv) -ne $(tail -n +2 test_case_$i.csv | grep -c .) ]
+    then
+        echo "priority energy model test $i did not terminate every process"
+    fi
+done
+
+# Dispatch overhead test case, a small and a large time quantum
+for i in {1..10} 
+do
+    echo "running dispatch overhead test $i"
+    ./main.exe test_case_$i.csv rr_overhead_test_$i.csv 21 3 1 5 50 2 >> average_time.txt
+    ./main.exe test_case_$i.csv rr_overhead_repeated_test_$i.csv 21 3 1 5 50 20 >> average_time.txt
+done
+
 # MM test case
 for i in {1..10} 
 do
     echo "running memory management test $i"
     ./main.exe test_case_$i.csv mm_test_$i.csv 4 0 500 250 150 100 >> average_time.txt
     ./main.exe test_case_$i.csv mm_repeated_test_$i.csv 4 0 300 300 350 50 >> average_time.txt
-done
\ No newline at end of file
+done
+
+# Transition log analysis test case, packing a log into the binary format and analysing it again
+# must give the same results as analysing the CSV log
+for log in rr_test_1 mm_test_1 rr_overhead_test_1
+do
+    echo "running transition log analysis test $log"
+    ./main.exe $log.csv ${log}_analysis.csv 5 >> average_time.txt
+    ./main.exe $log.csv $log.bin 5 >> average_time.txt
+    ./main.exe $log.bin ${log}_binary_analysis.csv 5 >> average_time.txt
+    for suffix in "" _queue _gantt _histogram
+    do
+        cmp -s ${log}_analysis$suffix.csv ${log}_binary_analysis$suffix.csv || echo "binary analysis of $log differs in ${log}_analysis$suffix.csv"
+    done
+done
+
+# Specialized kernel verification
+echo "running kernel verification"
+./main.exe fuzz verify_report.txt 10 1000 1 >> average_time.txt